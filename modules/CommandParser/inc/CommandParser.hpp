@@ -1,7 +1,10 @@
 #pragma once
+#include "CommandTable.hpp"
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <c4/format.hpp>
@@ -9,6 +12,9 @@
 #include <ryml_std.hpp>
 
 namespace CommandParser {
+// compiled dialects are stored here as <content hash>.bin
+constexpr const char *CACHE_DIRECTORY = "dialect_cache";
+
 class CommandParser {
 public:
   CommandParser();
@@ -16,7 +22,21 @@ public:
   void ReadYaml(const char filename[]);
   c4::yml::Tree GetCommandTree();
 
+  bool Load(const std::string &filename);
+  std::shared_ptr<const CommandTable> GetCommandTable() const;
+
 private:
+  static uint64_t HashContents(const std::string &contents);
+  static std::string CacheFilename(uint64_t hash);
+  static bool Flatten(ryml::ConstNodeRef node,
+                      const std::string &path,
+                      CommandTable::Entries &entries);
+  std::shared_ptr<const CommandTable> Compile(const std::string &contents,
+                                              uint64_t hash);
+
   ryml::Tree tree;
+  // replaced as a whole on load, readers keep the snapshot they took
+  std::shared_ptr<const CommandTable> table;
+  std::mutex load_mutex;
 };
 } // namespace CommandParser
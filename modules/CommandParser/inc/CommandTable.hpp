@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace CommandParser {
+constexpr uint32_t TABLE_MAGIC = 0x43505431; // "CPT1"
+
+/**
+ * Dialect flattened to sorted "section.key" -> command pairs, sequence
+ * items are keyed by their index ("acquisition.types.1"). Compiled form
+ * (host byte order):
+ *   u32 magic, u32 entry count, u64 hash of source yaml,
+ *   count x {u32 key offset, u32 key length, u32 value offset,
+ *            u32 value length},
+ *   string pool
+ * Offsets are relative to the string pool. Lookups binary search the
+ * entry array in place, so a memory-mapped compiled file is used without
+ * any parsing.
+ */
+class CommandTable {
+public:
+  using Entries = std::vector<std::pair<std::string, std::string>>;
+
+  ~CommandTable();
+  CommandTable(const CommandTable &) = delete;
+  CommandTable &operator=(const CommandTable &) = delete;
+
+  static std::vector<char> Compile(Entries entries, uint64_t hash);
+  static std::shared_ptr<const CommandTable> Map(const std::string &filename,
+                                                 uint64_t hash);
+  static std::shared_ptr<const CommandTable>
+  FromBuffer(std::vector<char> buffer, uint64_t hash);
+
+  std::string Get(std::string_view path) const;
+  bool Has(std::string_view path) const;
+  bool HasSection(std::string_view section) const;
+  size_t Size() const;
+  uint64_t GetHash() const;
+
+private:
+  struct Header {
+    uint32_t magic;
+    uint32_t count;
+    uint64_t hash;
+  };
+  struct Entry {
+    uint32_t key_offset;
+    uint32_t key_length;
+    uint32_t value_offset;
+    uint32_t value_length;
+  };
+
+  CommandTable() = default;
+  bool Validate(uint64_t hash) const;
+  const Header &GetHeader() const;
+  const Entry &GetEntry(size_t index) const;
+  std::string_view Key(size_t index) const;
+  std::string_view Value(size_t index) const;
+  size_t LowerBound(std::string_view path) const;
+
+  std::vector<char> buffer; // contents when not mapped
+  const char *data = nullptr;
+  size_t size = 0;
+  bool mapped = false;
+};
+} // namespace CommandParser
@@ -1,4 +1,8 @@
 #include "CommandParser.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <spdlog/spdlog.h>
 
 namespace CommandParserUtils {
 // helper functions for sample_parse_file()
@@ -60,7 +64,8 @@ static void file_put_contents(const char *filename,
 } // namespace CommandParserUtils
 
 namespace CommandParser {
-CommandParser::CommandParser() {}
+CommandParser::CommandParser()
+    : table(CommandTable::FromBuffer(CommandTable::Compile({}, 0), 0)) {}
 
 CommandParser::~CommandParser() {}
 
@@ -73,4 +78,146 @@ void CommandParser::ReadYaml(const char filename[]) {
 c4::yml::Tree CommandParser::GetCommandTree() {
   return this->tree;
 }
+
+/**
+ * Loads dialect file as command table. Compiled form is looked up in
+ * CACHE_DIRECTORY by hash of file contents and memory-mapped, yaml is
+ * parsed and compiled only when the contents were not seen before. On
+ * any error the current table is kept, so a half-edited file does not
+ * break a running session.
+ */
+bool CommandParser::Load(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) {
+    spdlog::error("Cannot open dialect file {}", filename);
+    return false;
+  }
+  const std::string contents((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+
+  std::lock_guard<std::mutex> lock(this->load_mutex);
+  const uint64_t hash = HashContents(contents);
+  if (std::atomic_load(&this->table)->GetHash() == hash) {
+    return true;
+  }
+
+  const std::string cache_filename = CacheFilename(hash);
+  auto loaded = CommandTable::Map(cache_filename, hash);
+  if (loaded != nullptr) {
+    spdlog::info("Dialect {} loaded from {}", filename, cache_filename);
+  } else {
+    loaded = Compile(contents, hash);
+    if (loaded == nullptr) {
+      spdlog::error("Dialect {} not loaded", filename);
+      return false;
+    }
+    spdlog::info("Dialect {} compiled, {} commands", filename, loaded->Size());
+  }
+  std::atomic_store(&this->table, loaded);
+  return true;
+}
+
+std::shared_ptr<const CommandTable> CommandParser::GetCommandTable() const {
+  return std::atomic_load(&this->table);
+}
+
+// FNV-1a
+uint64_t CommandParser::HashContents(const std::string &contents) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char c : contents) {
+    hash = (hash ^ (uint8_t)c) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::string CommandParser::CacheFilename(uint64_t hash) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+  return (std::filesystem::path(CACHE_DIRECTORY) / name).string();
+}
+
+bool CommandParser::Flatten(ryml::ConstNodeRef node,
+                            const std::string &path,
+                            CommandTable::Entries &entries) {
+  if (!node.is_map() && !node.is_seq()) {
+    if (!node.has_val()) {
+      spdlog::error("Dialect entry {} has no value", path);
+      return false;
+    }
+    auto value = node.val();
+    entries.emplace_back(path, std::string(value.data(), value.len));
+    return true;
+  }
+
+  size_t index = 0;
+  for (ryml::ConstNodeRef child : node.children()) {
+    std::string name = std::to_string(index++);
+    if (node.is_map()) {
+      auto key = child.key();
+      name = std::string(key.data(), key.len);
+    }
+    if (!Flatten(child, path.empty() ? name : path + '.' + name, entries)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Parses and validates yaml, then stores compiled form in cache. If the
+ * cache cannot be written, the compiled form is used from memory.
+ */
+std::shared_ptr<const CommandTable>
+CommandParser::Compile(const std::string &contents, uint64_t hash) {
+  CommandTable::Entries entries;
+  try {
+    ryml::Tree parsed = ryml::parse_in_arena(ryml::to_csubstr(contents));
+    if (!parsed.rootref().is_map()) {
+      spdlog::error("Dialect root is not a map");
+      return nullptr;
+    }
+    if (!Flatten(parsed.rootref(), "", entries)) {
+      return nullptr;
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Error parsing dialect:\n{}", e.what());
+    return nullptr;
+  }
+
+  std::sort(entries.begin(), entries.end());
+  for (size_t i = 1; i < entries.size(); i++) {
+    if (entries[i - 1].first == entries[i].first) {
+      spdlog::error("Dialect entry {} defined twice", entries[i].first);
+      return nullptr;
+    }
+  }
+
+  std::vector<char> compiled = CommandTable::Compile(std::move(entries), hash);
+  const std::filesystem::path cache_path = CacheFilename(hash);
+  const std::filesystem::path temporary_path = cache_path.string() + ".tmp";
+  std::error_code error;
+  std::filesystem::create_directories(CACHE_DIRECTORY, error);
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    file.write(compiled.data(), (std::streamsize)compiled.size());
+    if (!file) {
+      error = std::make_error_code(std::errc::io_error);
+    }
+  }
+  // renamed into place, so a cache file is never seen half written
+  if (!error) {
+    std::filesystem::rename(temporary_path, cache_path, error);
+  }
+  if (error) {
+    spdlog::warn("Compiled dialect not cached: {}", error.message());
+    std::filesystem::remove(temporary_path, error);
+    return CommandTable::FromBuffer(std::move(compiled), hash);
+  }
+
+  auto mapped = CommandTable::Map(cache_path.string(), hash);
+  if (mapped == nullptr) {
+    return CommandTable::FromBuffer(std::move(compiled), hash);
+  }
+  return mapped;
+}
 }; // namespace CommandParser
@@ -0,0 +1,230 @@
+#include "CommandTable.hpp"
+#include <algorithm>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CommandParser {
+CommandTable::~CommandTable() {
+  if (!this->mapped) {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(this->data);
+#else
+  munmap(const_cast<char *>(this->data), this->size);
+#endif
+}
+
+/**
+ * Builds compiled form of entries. Entries are sorted here, duplicate
+ * keys should be rejected by the caller beforehand.
+ */
+std::vector<char> CommandTable::Compile(Entries entries, uint64_t hash) {
+  std::sort(entries.begin(), entries.end());
+
+  const size_t pool_start = sizeof(Header) + entries.size() * sizeof(Entry);
+  size_t pool_size = 0;
+  for (const auto &[key, value] : entries) {
+    pool_size += key.size() + value.size();
+  }
+  std::vector<char> buffer(pool_start + pool_size);
+
+  Header header{TABLE_MAGIC, (uint32_t)entries.size(), hash};
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  char *pool = buffer.data() + pool_start;
+  size_t offset = 0;
+  for (size_t i = 0; i < entries.size(); i++) {
+    const auto &[key, value] = entries[i];
+    Entry entry{(uint32_t)offset,
+                (uint32_t)key.size(),
+                (uint32_t)(offset + key.size()),
+                (uint32_t)value.size()};
+    std::memcpy(buffer.data() + sizeof(Header) + i * sizeof(Entry),
+                &entry,
+                sizeof(entry));
+    std::memcpy(pool + offset, key.data(), key.size());
+    offset += key.size();
+    std::memcpy(pool + offset, value.data(), value.size());
+    offset += value.size();
+  }
+  return buffer;
+}
+
+/**
+ * Maps compiled file read-only. Returns nullptr if it cannot be mapped or
+ * was not compiled from yaml with given hash.
+ */
+std::shared_ptr<const CommandTable>
+CommandTable::Map(const std::string &filename, uint64_t hash) {
+  std::shared_ptr<CommandTable> table(new CommandTable());
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_DELETE,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+  LARGE_INTEGER file_size;
+  HANDLE mapping = nullptr;
+  if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+    mapping =
+        CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  }
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return nullptr;
+  }
+  // view keeps the mapping alive after its handle is closed
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (view == nullptr) {
+    return nullptr;
+  }
+  table->size = (size_t)file_size.QuadPart;
+#else
+  int file = open(filename.c_str(), O_RDONLY);
+  if (file < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  void *view = MAP_FAILED;
+  if (fstat(file, &file_stat) == 0 && file_stat.st_size > 0) {
+    view = mmap(
+        nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+  }
+  close(file);
+  if (view == MAP_FAILED) {
+    return nullptr;
+  }
+  table->size = (size_t)file_stat.st_size;
+#endif
+  table->data = static_cast<const char *>(view);
+  table->mapped = true;
+
+  if (!table->Validate(hash)) {
+    spdlog::warn("Compiled dialect {} is invalid or stale", filename);
+    return nullptr;
+  }
+  return table;
+}
+
+std::shared_ptr<const CommandTable>
+CommandTable::FromBuffer(std::vector<char> buffer, uint64_t hash) {
+  std::shared_ptr<CommandTable> table(new CommandTable());
+  table->buffer = std::move(buffer);
+  table->data = table->buffer.data();
+  table->size = table->buffer.size();
+  if (!table->Validate(hash)) {
+    spdlog::error("Compiled dialect buffer is invalid");
+    return nullptr;
+  }
+  return table;
+}
+
+/**
+ * Returns command at path, e.g. "measurements.voltage_rms". Missing
+ * commands are logged and returned empty.
+ */
+std::string CommandTable::Get(std::string_view path) const {
+  const size_t index = LowerBound(path);
+  if (index == Size() || Key(index) != path) {
+    spdlog::error("Command {} not found in dialect", path);
+    return "";
+  }
+  return std::string(Value(index));
+}
+
+bool CommandTable::Has(std::string_view path) const {
+  const size_t index = LowerBound(path);
+  return index < Size() && Key(index) == path;
+}
+
+bool CommandTable::HasSection(std::string_view section) const {
+  const std::string prefix = std::string(section) + '.';
+  const size_t index = LowerBound(prefix);
+  return index < Size() && Key(index).substr(0, prefix.size()) == prefix;
+}
+
+size_t CommandTable::Size() const {
+  return GetHeader().count;
+}
+
+uint64_t CommandTable::GetHash() const {
+  return GetHeader().hash;
+}
+
+// checked once, so lookups can trust offsets and ordering
+bool CommandTable::Validate(uint64_t hash) const {
+  if (this->size < sizeof(Header)) {
+    return false;
+  }
+  const Header &header = GetHeader();
+  if (header.magic != TABLE_MAGIC || header.hash != hash) {
+    return false;
+  }
+  const size_t pool_start = sizeof(Header) + header.count * sizeof(Entry);
+  if (this->size < pool_start) {
+    return false;
+  }
+  const size_t pool_size = this->size - pool_start;
+  for (size_t i = 0; i < header.count; i++) {
+    const Entry &entry = GetEntry(i);
+    if ((size_t)entry.key_offset + entry.key_length > pool_size ||
+        (size_t)entry.value_offset + entry.value_length > pool_size) {
+      return false;
+    }
+    if (i > 0 && !(Key(i - 1) < Key(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const CommandTable::Header &CommandTable::GetHeader() const {
+  return *reinterpret_cast<const Header *>(this->data);
+}
+
+const CommandTable::Entry &CommandTable::GetEntry(size_t index) const {
+  return reinterpret_cast<const Entry *>(this->data + sizeof(Header))[index];
+}
+
+std::string_view CommandTable::Key(size_t index) const {
+  const Entry &entry = GetEntry(index);
+  const char *pool = this->data + sizeof(Header) + Size() * sizeof(Entry);
+  return std::string_view(pool + entry.key_offset, entry.key_length);
+}
+
+std::string_view CommandTable::Value(size_t index) const {
+  const Entry &entry = GetEntry(index);
+  const char *pool = this->data + sizeof(Header) + Size() * sizeof(Entry);
+  return std::string_view(pool + entry.value_offset, entry.value_length);
+}
+
+// first entry with key not less than path
+size_t CommandTable::LowerBound(std::string_view path) const {
+  size_t low = 0;
+  size_t high = Size();
+  while (low < high) {
+    const size_t middle = (low + high) / 2;
+    if (Key(middle) < path) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+} // namespace CommandParser
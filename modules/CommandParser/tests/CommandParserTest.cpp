@@ -0,0 +1,109 @@
+/*********************************************************************
+ * \file   CommandParserTest.cpp
+ * \brief  Unit tests of dialect loading through the compiled cache
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "CommandParser.hpp"
+#include "TestSupport.hpp"
+#include <cstdio>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+static const fs::path DIRECTORY =
+    fs::temp_directory_path() / "CommandParserTest";
+static const char *DIALECT = "utils:\n"
+                             "  autoscale: \":AUT\"\n"
+                             "acquisition:\n"
+                             "  types:\n"
+                             "    - NORM\n"
+                             "    - AVER\n";
+
+static void writeFile(const fs::path &path, const std::string &contents) {
+  // renamed into place, mapped files are never rewritten in place
+  const fs::path temporary = path.string() + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file << contents;
+  }
+  fs::rename(temporary, path);
+}
+
+static fs::path cacheFile(uint64_t hash) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+  return fs::path(CommandParser::CACHE_DIRECTORY) / name;
+}
+
+static bool hasDialect(const CommandParser::CommandParser &parser) {
+  auto table = parser.GetCommandTable();
+  return table->Get("utils.autoscale") == ":AUT" &&
+         table->Get("acquisition.types.1") == "AVER";
+}
+
+/**
+ * Damaged cache files and ones compiled from other contents are compiled
+ * again from yaml and replaced.
+ */
+static void testRejectsBadCache() {
+  uint64_t hash = 0;
+  {
+    CommandParser::CommandParser parser;
+    CHECK(parser.Load("dialect.yml"));
+    CHECK(hasDialect(parser));
+    hash = parser.GetCommandTable()->GetHash();
+  }
+  const fs::path cache = cacheFile(hash);
+  CHECK(fs::exists(cache));
+  CHECK(CommandParser::CommandTable::Map(cache.string(), hash) != nullptr);
+
+  writeFile(cache, "not a compiled dialect");
+  {
+    CommandParser::CommandParser parser;
+    CHECK(parser.Load("dialect.yml"));
+    CHECK(hasDialect(parser));
+  }
+  CHECK(CommandParser::CommandTable::Map(cache.string(), hash) != nullptr);
+
+  // valid table of other yaml stored under this name
+  std::vector<char> stale = CommandParser::CommandTable::Compile(
+      {{"utils.autoscale", ":OTHER"}}, hash + 1);
+  writeFile(cache, std::string(stale.begin(), stale.end()));
+  {
+    CommandParser::CommandParser parser;
+    CHECK(parser.Load("dialect.yml"));
+    CHECK(hasDialect(parser));
+  }
+  CHECK(CommandParser::CommandTable::Map(cache.string(), hash) != nullptr);
+}
+
+// file that does not parse leaves commands of the previous one in place
+static void testKeepsTableOnError() {
+  CommandParser::CommandParser parser;
+  CHECK(parser.Load("dialect.yml"));
+  auto before = parser.GetCommandTable();
+
+  writeFile("broken.yml", "utils: [autoscale\n");
+  CHECK(!parser.Load("broken.yml"));
+  writeFile("duplicate.yml", "utils:\n  a: X\n  a: Y\n");
+  CHECK(!parser.Load("duplicate.yml"));
+  CHECK(!parser.Load("missing.yml"));
+  CHECK(parser.GetCommandTable() == before);
+  CHECK(hasDialect(parser));
+}
+
+int main() {
+  fs::remove_all(DIRECTORY);
+  fs::create_directories(DIRECTORY);
+  fs::current_path(DIRECTORY); // cache directory is relative
+  writeFile("dialect.yml", DIALECT);
+
+  testRejectsBadCache();
+  testKeepsTableOnError();
+
+  fs::current_path(fs::temp_directory_path());
+  fs::remove_all(DIRECTORY);
+  return TestSupport::Result();
+}
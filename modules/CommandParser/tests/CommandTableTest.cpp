@@ -0,0 +1,140 @@
+/*********************************************************************
+ * \file   CommandTableTest.cpp
+ * \brief  Unit tests of CommandTable lookups and compiled form validation
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "CommandTable.hpp"
+#include "TestSupport.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace CommandParser;
+
+constexpr uint64_t HASH = 0x1234567890abcdefULL;
+// header is u32 magic, u32 count, u64 hash, entries of 4 x u32 follow
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t ENTRY_SIZE = 16;
+
+static const std::string FILENAME =
+    (std::filesystem::temp_directory_path() / "CommandTableTest.bin")
+        .string();
+
+static std::vector<char> compiled() {
+  return CommandTable::Compile({{"utils.autoscale", ":AUT"},
+                                {"acquisition.types.1", "AVER"},
+                                {"acquisition.types.0", "NORM"},
+                                {"measurements.get_result", ""}},
+                               HASH);
+}
+
+/**
+ * Written to a new file and renamed like the dialect cache, a file that
+ * is still mapped must not be truncated in place.
+ */
+static void writeFile(const std::vector<char> &contents) {
+  const std::string temporary = FILENAME + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), (std::streamsize)contents.size());
+  }
+  std::filesystem::rename(temporary, FILENAME);
+}
+
+static void setU32(std::vector<char> &buffer, size_t offset, uint32_t value) {
+  std::memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+static void testLookups() {
+  auto table = CommandTable::FromBuffer(compiled(), HASH);
+  CHECK(table != nullptr);
+  if (table == nullptr) {
+    return;
+  }
+  CHECK(table->Size() == 4);
+  CHECK(table->GetHash() == HASH);
+  CHECK(table->Get("utils.autoscale") == ":AUT");
+  CHECK(table->Get("acquisition.types.0") == "NORM");
+  CHECK(table->Get("acquisition.types.1") == "AVER");
+  CHECK(table->Has("measurements.get_result"));
+  CHECK(table->Get("measurements.get_result").empty());
+  CHECK(!table->Has("utils"));
+  CHECK(table->Get("utils.missing").empty());
+  CHECK(table->HasSection("acquisition.types"));
+  CHECK(table->HasSection("utils"));
+  CHECK(!table->HasSection("util"));
+
+  auto empty = CommandTable::FromBuffer(CommandTable::Compile({}, 0), 0);
+  CHECK(empty != nullptr && empty->Size() == 0);
+  CHECK(empty != nullptr && !empty->Has("utils.autoscale"));
+}
+
+// every damaged buffer is rejected before lookups trust its offsets
+static void testRejectsCorrupt() {
+  CHECK(CommandTable::FromBuffer(compiled(), HASH + 1) == nullptr);
+
+  std::vector<char> buffer = compiled();
+  setU32(buffer, 0, 0x31545043); // magic of other byte order
+  CHECK(CommandTable::FromBuffer(buffer, HASH) == nullptr);
+
+  buffer = compiled();
+  buffer.resize(HEADER_SIZE - 1);
+  CHECK(CommandTable::FromBuffer(buffer, HASH) == nullptr);
+
+  buffer = compiled();
+  buffer.resize(HEADER_SIZE + 3 * ENTRY_SIZE); // entries cut off
+  CHECK(CommandTable::FromBuffer(buffer, HASH) == nullptr);
+
+  buffer = compiled();
+  setU32(buffer, 4, 0xffffffff); // entry count
+  CHECK(CommandTable::FromBuffer(buffer, HASH) == nullptr);
+
+  buffer = compiled();
+  buffer.pop_back(); // last value runs past the pool
+  CHECK(CommandTable::FromBuffer(buffer, HASH) == nullptr);
+
+  buffer = compiled();
+  setU32(buffer, HEADER_SIZE + 2 * ENTRY_SIZE + 8, 0x7fffffff);
+  CHECK(CommandTable::FromBuffer(buffer, HASH) == nullptr);
+
+  // entries out of order would break binary search
+  buffer = compiled();
+  std::vector<char> first(buffer.begin() + HEADER_SIZE,
+                          buffer.begin() + HEADER_SIZE + ENTRY_SIZE);
+  std::copy(buffer.begin() + HEADER_SIZE + ENTRY_SIZE,
+            buffer.begin() + HEADER_SIZE + 2 * ENTRY_SIZE,
+            buffer.begin() + HEADER_SIZE);
+  std::copy(
+      first.begin(), first.end(), buffer.begin() + HEADER_SIZE + ENTRY_SIZE);
+  CHECK(CommandTable::FromBuffer(buffer, HASH) == nullptr);
+}
+
+// cache files of other yaml contents or damaged ones are not mapped
+static void testMapValidatesCache() {
+  writeFile(compiled());
+  auto table = CommandTable::Map(FILENAME, HASH);
+  CHECK(table != nullptr && table->Get("utils.autoscale") == ":AUT");
+  CHECK(CommandTable::Map(FILENAME, HASH ^ 1) == nullptr);
+
+  std::vector<char> truncated = compiled();
+  truncated.resize(truncated.size() / 2);
+  writeFile(truncated);
+  CHECK(CommandTable::Map(FILENAME, HASH) == nullptr);
+
+  writeFile({});
+  CHECK(CommandTable::Map(FILENAME, HASH) == nullptr);
+
+  std::filesystem::remove(FILENAME);
+  CHECK(CommandTable::Map(FILENAME, HASH) == nullptr);
+  // mapped table stays valid after its file is gone
+  CHECK(table != nullptr && table->Get("acquisition.types.1") == "AVER");
+}
+
+int main() {
+  testLookups();
+  testRejectsCorrupt();
+  testMapValidatesCache();
+  return TestSupport::Result();
+}
@@ -7,17 +7,32 @@
  *********************************************************************/
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cstdbool>
+#include <condition_variable>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include "TransferProfile.hpp"
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
+#include <thread>
 #include <tuple>
 #include <vector>
 #include <visa.h>
 #include <visatype.h>
 
 constexpr size_t BUFFER_SIZE_B = 8000;
+constexpr ViUInt32 SRQ_TIMEOUT_MS = 10000;
+
+// IEEE 488.2 status registers bits used for operation complete SRQ
+constexpr ViUInt16 ESE_OPC_BIT = 0x01;
+constexpr ViUInt16 STB_ESB_BIT = 0x20;
 
 #ifdef _WIN32
 #define ViRsrc ViConstRsrc
@@ -34,7 +49,30 @@ private:
   ViChar buffer[BUFFER_SIZE_B] = {0};
   ViUInt32 io_bytes;
   const ViAccessMode access_mode = VI_NULL;
-  const ViUInt32 timeout_ms = 200;
+  ViUInt32 timeout_ms = 200;
+
+  TransferProfile transfer_profile;
+  bool transfer_profile_active = false;
+
+  std::recursive_mutex io_mutex; // serializes IO with SRQ waiting thread
+  // changed under io_mutex on connect and disconnect, waits started in an
+  // earlier session must not touch the current one
+  std::atomic<unsigned> session_generation{0};
+  bool service_request_enabled = false;
+  bool service_request_unsupported = false; // e.g. raw socket or serial
+
+  struct NotifyRequest {
+    std::string command;
+    std::function<void(bool)> callback;
+    ViUInt32 timeout;
+    unsigned generation; // session the request was queued in
+  };
+  // operations waited for one after another by a long-lived thread
+  std::thread notify_thread;
+  std::mutex notify_mutex;
+  std::condition_variable notify_condition;
+  std::deque<NotifyRequest> notify_queue;
+  bool notify_stop = false;
 
   std::string resource_string;
   std::vector<ViChar> ID_string;
@@ -51,6 +89,14 @@ private:
   void SetResourceString(ViChar ResourceString[]);
   bool ReadIDString();
   void SetIDString(ViChar IDString[]);
+  void NotifyLoop();
+  bool WriteAndWaitInSession(const char *scpi_command,
+                             ViUInt32 timeout,
+                             unsigned generation);
+  bool WaitForServiceRequestInSession(ViUInt32 timeout,
+                                      ViSession session,
+                                      unsigned generation);
+  bool ReadBlockData(std::vector<ViByte> &block, ViUInt32 chunk_size);
   /*
    * PRIVATE METHODS END
    */
@@ -68,11 +114,37 @@ public:
   bool Connect(ViChar ResourceString[]);
   bool Disconnect();
 
+  // reply points into the session buffer, callers sharing the session
+  // with other threads copy it while holding LockSession()
   std::tuple<bool, ViChar *> Query(const char *scpi_command);
   bool Write(const char *scpi_command);
   std::tuple<bool, ViChar *> Read();
+  std::tuple<bool, ViUInt32> ReadRaw(ViByte *destination, ViUInt32 count);
+  bool ReadBlock(std::vector<ViByte> &block, ViUInt32 chunk_size);
+  bool ReadBlock(std::vector<ViByte> &block);
+  bool ReadResponse(std::vector<ViByte> &response, ViUInt32 chunk_size);
   ViStatus ViClear();
 
+  bool SetTimeout(ViUInt32 timeout);
+  ViUInt32 GetTimeout();
+  bool SetBufferSize(ViUInt32 size);
+  bool SetTermCharEnabled(bool enabled);
+  ViUInt16 GetInterfaceType();
+
+  bool EnableServiceRequest();
+  bool WaitForServiceRequest(ViUInt32 timeout);
+  bool WriteAndWait(const char *scpi_command,
+                    ViUInt32 timeout = SRQ_TIMEOUT_MS);
+  void WriteAndNotify(const char *scpi_command,
+                      std::function<void(bool)> callback,
+                      ViUInt32 timeout = SRQ_TIMEOUT_MS);
+
+  void ApplyTransferProfile(const TransferProfile &profile);
+  TransferProfile GetTransferProfile();
+  ViUInt32 TimeoutForRecord(size_t record_bytes);
+
+  std::unique_lock<std::recursive_mutex> LockSession();
+
   /*
    * PUBLIC METHODS END
    */
@@ -0,0 +1,54 @@
+/*********************************************************************
+ * \file   TransferProfile.hpp
+ * \brief  Transfer parameters tuned per instrument and their storage
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <visa.h>
+#include <visatype.h>
+
+namespace InstrumentControl {
+struct TransferProfile {
+  std::string instrument_id;
+  ViUInt16 interface_type = 0;
+  ViUInt32 chunk_size = 8000;     // bytes per viRead call
+  ViUInt32 buffer_size = 4096;    // viSetBuf I/O buffer size
+  ViUInt32 base_timeout_ms = 200; // timeout for short replies
+  double timeout_ms_per_mb = 0.0; // added per MB of expected reply
+  int sample_width = 1;           // waveform encoding: 1 - BYTE, 2 - WORD
+  double throughput_mb_s = 0.0;   // measured during tuning
+};
+
+/**
+ * Keeps tuned profiles keyed by instrument ID string and interface type,
+ * an instrument reachable over several interfaces has a profile for each.
+ * Stored as one tab separated line per profile so later connections start
+ * tuned.
+ */
+class TransferProfileStore {
+public:
+  explicit TransferProfileStore(
+      std::string filename = "transfer_profiles.txt");
+
+  bool Load();
+  bool Save();
+
+  bool Find(const std::string &instrument_id,
+            ViUInt16 interface_type,
+            TransferProfile &profile);
+  void Store(const TransferProfile &profile);
+
+private:
+  using Key = std::pair<std::string, ViUInt16>;
+
+  std::string filename;
+  std::map<Key, TransferProfile> profiles;
+};
+} // namespace InstrumentControl
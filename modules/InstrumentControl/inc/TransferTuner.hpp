@@ -0,0 +1,50 @@
+/*********************************************************************
+ * \file   TransferTuner.hpp
+ * \brief  Throughput based selection of waveform transfer parameters
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "InstrumentControl.hpp"
+#include "TransferProfile.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace InstrumentControl {
+struct TuningRequest {
+  std::string data_query;          // query returning waveform binary block
+  std::string format_byte_command; // selects 1 byte samples
+  std::string format_word_command; // selects 2 byte samples
+  int precision_floor_bits = 8;    // minimum sample resolution user accepts
+  double frame_budget_ms = 100.0;  // WORD is used if record fits this budget
+  int reads_per_candidate = 3;
+};
+
+/**
+ * Measures block read throughput of the connected instrument for chunk
+ * sizes fitting its interface type, then for I/O buffer sizes with the
+ * fastest chunk, and builds a profile with the fastest combination,
+ * timeout scaling and sample width. Session settings are left as they were,
+ * the profile takes effect with InstrumentControl::ApplyTransferProfile.
+ */
+class TransferTuner {
+public:
+  explicit TransferTuner(InstrumentControl &scope);
+
+  TransferProfile Tune(const TuningRequest &request);
+
+private:
+  std::vector<ViUInt32> CandidateChunkSizes(ViUInt16 interface_type);
+  std::vector<ViUInt32> CandidateBufferSizes(ViUInt16 interface_type);
+  double MeasureQueryLatencyMs();
+  bool MeasureBlockRead(const TuningRequest &request,
+                        ViUInt32 chunk_size,
+                        ViUInt32 buffer_size,
+                        double &throughput_mb_s,
+                        size_t &record_bytes);
+
+  InstrumentControl &scope;
+};
+} // namespace InstrumentControl
@@ -12,7 +12,16 @@ namespace InstrumentControl {
 InstrumentControl::InstrumentControl() {}
 
 InstrumentControl::~InstrumentControl() {
+  {
+    std::lock_guard<std::mutex> lock(this->notify_mutex);
+    this->notify_stop = true;
+  }
+  this->notify_condition.notify_all();
+  // closing the session ends a wait in progress
   this->Disconnect();
+  if (this->notify_thread.joinable()) {
+    this->notify_thread.join();
+  }
 }
 
 /*
@@ -31,11 +40,172 @@ bool InstrumentControl::ReadIDString() {
 }
 
 void InstrumentControl::SetIDString(ViChar IDString[]) {
-  this->ID_string.insert(this->ID_string.end(),
-                         IDString,
-                         IDString + std::strlen(IDString));
+  size_t length = std::strlen(IDString);
+  // drop line terminator so ID can be used as a key
+  while (length > 0 && std::isspace((unsigned char)IDString[length - 1])) {
+    length--;
+  }
+  this->ID_string.assign(IDString, IDString + length);
   spdlog::info("ID string set to {}", IDString);
 }
+
+void InstrumentControl::NotifyLoop() {
+  std::unique_lock<std::mutex> lock(this->notify_mutex);
+  while (true) {
+    this->notify_condition.wait(lock, [this]() {
+      return this->notify_stop || !this->notify_queue.empty();
+    });
+    if (this->notify_stop) {
+      return;
+    }
+    NotifyRequest request = std::move(this->notify_queue.front());
+    this->notify_queue.pop_front();
+
+    lock.unlock();
+    request.callback(WriteAndWaitInSession(
+        request.command.c_str(), request.timeout, request.generation));
+    lock.lock();
+  }
+}
+
+// fails without IO when the session was closed after generation started
+bool InstrumentControl::WriteAndWaitInSession(const char *scpi_command,
+                                              ViUInt32 timeout,
+                                              unsigned generation) {
+  ViSession session;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+    if (generation != this->session_generation) {
+      spdlog::debug("Session closed before {} was written", scpi_command);
+      return false;
+    }
+    if (!EnableServiceRequest()) {
+      const ViUInt32 previous_timeout = this->timeout_ms;
+      SetTimeout(std::max(previous_timeout, timeout));
+      std::string command = std::string(scpi_command) + ";*OPC?";
+      auto [success, reply] = Query(command.c_str());
+      SetTimeout(previous_timeout);
+      return success;
+    }
+    viDiscardEvents(this->instrument, VI_EVENT_SERVICE_REQ, VI_QUEUE);
+
+    std::string command = std::string(scpi_command) + ";*OPC";
+    if (!Write(command.c_str())) {
+      return false;
+    }
+    session = this->instrument;
+  }
+
+  return WaitForServiceRequestInSession(timeout, session, generation);
+}
+
+bool InstrumentControl::WaitForServiceRequestInSession(ViUInt32 timeout,
+                                                       ViSession session,
+                                                       unsigned generation) {
+  ViEventType event_type;
+  ViEvent event;
+  ViStatus wait_status = viWaitOnEvent(
+      session, VI_EVENT_SERVICE_REQ, timeout, &event_type, &event);
+  if (wait_status < VI_SUCCESS) {
+    if (generation != this->session_generation) {
+      spdlog::debug("Session closed while waiting for service request");
+    } else {
+      // callers decide whether a slow operation is an error
+      spdlog::warn(
+          "No service request within {} ms: {}", timeout, wait_status);
+    }
+    return false;
+  }
+  viClose(event);
+
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  if (generation != this->session_generation) {
+    spdlog::debug("Session closed while waiting for service request");
+    return false;
+  }
+  ViUInt16 status_byte = 0;
+  viReadSTB(this->instrument, &status_byte);
+  // reading ESR clears OPC bit for the next operation
+  Query("*ESR?");
+
+  spdlog::debug("Service request received, status byte: {}", status_byte);
+  return (status_byte & STB_ESB_BIT) != 0;
+}
+
+// caller holds io_mutex, indefinite length blocks (#0) are read until END
+bool InstrumentControl::ReadBlockData(std::vector<ViByte> &block,
+                                      ViUInt32 chunk_size) {
+  ViByte header[10] = {0};
+  block.clear();
+
+  // '#' and number of length digits
+  if (!std::get<bool>(ReadRaw(header, 2)) || header[0] != '#') {
+    spdlog::error("Response is not a binary block");
+    return false;
+  }
+
+  const int digits = header[1] - '0';
+  if (digits < 0 || digits > 9) {
+    spdlog::error("Malformed binary block header");
+    return false;
+  }
+
+  if (digits == 0) {
+    // indefinite length block - read until instrument asserts END
+    ViUInt32 offset = 0;
+    do {
+      block.resize(offset + chunk_size);
+      auto [success, count] = ReadRaw(block.data() + offset, chunk_size);
+      if (!success) {
+        return false;
+      }
+      offset += count;
+    } while (this->status == VI_SUCCESS_MAX_CNT);
+    block.resize(offset);
+    return true;
+  }
+
+  if (!std::get<bool>(ReadRaw(header, (ViUInt32)digits))) {
+    return false;
+  }
+  header[digits] = 0;
+  const ViUInt32 length = std::strtoul((const char *)header, nullptr, 10);
+
+  // with tuned profile, scale timeout by the announced record length
+  const ViUInt32 previous_timeout = this->timeout_ms;
+  if (this->transfer_profile_active) {
+    SetTimeout(TimeoutForRecord(length));
+  }
+
+  block.resize(length);
+  ViUInt32 offset = 0;
+  bool success = true;
+  while (offset < length) {
+    auto [read_success, count] =
+        ReadRaw(block.data() + offset, std::min(chunk_size, length - offset));
+    if (!read_success) {
+      block.resize(offset);
+      success = false;
+      break;
+    }
+    offset += count;
+  }
+
+  if (this->transfer_profile_active) {
+    SetTimeout(previous_timeout);
+  }
+  if (!success) {
+    return false;
+  }
+
+  // drop trailing terminator left after the block
+  if (this->status == VI_SUCCESS_MAX_CNT) {
+    ReadRaw(header, sizeof(header));
+  }
+
+  spdlog::debug("Binary block read succesful! Bytes read: {}", length);
+  return true;
+}
 /*
  *   PRIVATE METHODS END
  */
@@ -52,7 +222,14 @@ std::string InstrumentControl::GetIDString() {
 }
 
 bool InstrumentControl::Connect(ViChar ResourceString[]) {
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+    this->session_generation++;
+  }
   SetResourceString(ResourceString); // set instrument resource string
+  this->transfer_profile_active = false;
+  this->service_request_enabled = false;
+  this->service_request_unsupported = false;
   this->status =
       viOpenDefaultRM(&this->resource_manager); // open VISA resource manager
   if (this->status < VI_SUCCESS) {
@@ -88,7 +265,29 @@ bool InstrumentControl::Connect(ViChar ResourceString[]) {
   return true;
 }
 
+/**
+ * Does not wait for an operation tracked by WriteAndNotify, closing the
+ * session ends its wait with failure and the operation does not touch a
+ * session opened later. Operations not started yet are dropped and their
+ * callbacks called with false.
+ */
 bool InstrumentControl::Disconnect() {
+  std::deque<NotifyRequest> dropped;
+  {
+    std::lock_guard<std::mutex> lock(this->notify_mutex);
+    dropped.swap(this->notify_queue);
+  }
+  for (const NotifyRequest &request : dropped) {
+    request.callback(false);
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  this->session_generation++;
+  if (this->service_request_enabled) {
+    viDisableEvent(this->instrument, VI_EVENT_SERVICE_REQ, VI_QUEUE);
+    this->service_request_enabled = false;
+  }
+
   this->status = viClose(this->instrument);
   if (this->status < VI_SUCCESS) {
     ;
@@ -104,6 +303,7 @@ bool InstrumentControl::Disconnect() {
 }
 
 std::tuple<bool, ViChar *> InstrumentControl::Query(const char *scpi_command) {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
   std::tuple<bool, ViChar *> temp;
   Write(scpi_command);
   temp = Read();
@@ -112,6 +312,7 @@ std::tuple<bool, ViChar *> InstrumentControl::Query(const char *scpi_command) {
 }
 
 bool InstrumentControl::Write(const char *scpi_command) {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
   // write command
   this->status = viWrite(this->instrument,
                          (ViBuf)scpi_command,
@@ -130,6 +331,7 @@ bool InstrumentControl::Write(const char *scpi_command) {
 }
 
 std::tuple<bool, ViChar *> InstrumentControl::Read() {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
   // read response
   this->status = viRead(this->instrument,
                         (ViPBuf)this->buffer,
@@ -142,17 +344,278 @@ std::tuple<bool, ViChar *> InstrumentControl::Read() {
                   this->buffer);
     return {false, this->buffer};
   }
+  // terminate reply so data left from previous longer reply is not returned
+  this->buffer[std::min<ViUInt32>(this->io_bytes, BUFFER_SIZE_B - 1)] = 0;
 
   spdlog::info("Read succesful! Returned value: {}", this->buffer);
   return {true, this->buffer};
 }
 
+/**
+ * Reads up to count raw bytes straight into the caller's buffer.
+ * Returns success flag and number of bytes actually transferred.
+ */
+std::tuple<bool, ViUInt32> InstrumentControl::ReadRaw(ViByte *destination,
+                                                      ViUInt32 count) {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  this->status =
+      viRead(this->instrument, (ViPBuf)destination, count, &this->io_bytes);
+  if (this->status < VI_SUCCESS) {
+    viStatusDesc(this->resource_manager, this->status, this->buffer);
+    spdlog::error("Error reading raw data from instrument:\n{}\n{}",
+                  this->status,
+                  this->buffer);
+    return {false, this->io_bytes};
+  }
+
+  spdlog::debug("Raw read succesful! Bytes read: {}", this->io_bytes);
+  return {true, this->io_bytes};
+}
+
+/**
+ * Reads IEEE 488.2 block response (#<n><length><data>) in chunks of
+ * chunk_size bytes. Termination character is disabled only while the block
+ * is read, text replies on serial and raw socket links still end with it.
+ */
+bool InstrumentControl::ReadBlock(std::vector<ViByte> &block,
+                                  ViUInt32 chunk_size) {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  ViBoolean termchar_enabled = VI_FALSE;
+  viGetAttribute(this->instrument, VI_ATTR_TERMCHAR_EN, &termchar_enabled);
+  if (termchar_enabled == VI_TRUE && !SetTermCharEnabled(false)) {
+    return false;
+  }
+
+  const bool success = ReadBlockData(block, chunk_size);
+
+  if (termchar_enabled == VI_TRUE) {
+    SetTermCharEnabled(true);
+  }
+  return success;
+}
+
+bool InstrumentControl::ReadBlock(std::vector<ViByte> &block) {
+  return ReadBlock(block, this->transfer_profile.chunk_size);
+}
+
+/**
+ * Reads response of any length until END in chunks of chunk_size bytes,
+ * for text replies too long for the internal buffer. Capacity of response
+ * is kept, so reading into the same vector again does not allocate.
+ */
+bool InstrumentControl::ReadResponse(std::vector<ViByte> &response,
+                                     ViUInt32 chunk_size) {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  size_t offset = 0;
+  do {
+    response.resize(offset + chunk_size);
+    auto [success, count] = ReadRaw(response.data() + offset, chunk_size);
+    if (!success) {
+      response.resize(offset);
+      return false;
+    }
+    offset += count;
+  } while (this->status == VI_SUCCESS_MAX_CNT);
+  response.resize(offset);
+
+  spdlog::debug("Response read succesful! Bytes read: {}", offset);
+  return true;
+}
+
 ViStatus InstrumentControl::ViClear() {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
   ViStatus status = viClear(this->resource_manager);
   spdlog::info("VI clear status: {}", this->status);
   return status;
 }
 
+bool InstrumentControl::SetTimeout(ViUInt32 timeout) {
+  this->status = viSetAttribute(this->instrument, VI_ATTR_TMO_VALUE, timeout);
+  if (this->status < VI_SUCCESS) {
+    viStatusDesc(this->resource_manager, this->status, this->buffer);
+    spdlog::error("Error setting timeout:\n{}\n{}", this->status, this->buffer);
+    return false;
+  }
+
+  this->timeout_ms = timeout;
+  spdlog::info("Timeout set to {} ms", timeout);
+  return true;
+}
+
+ViUInt32 InstrumentControl::GetTimeout() {
+  return this->timeout_ms;
+}
+
+/**
+ * Sizes the low level I/O buffers used by viRead/viWrite. VI_READ_BUF and
+ * VI_WRITE_BUF would only affect formatted I/O, which is not used here.
+ */
+bool InstrumentControl::SetBufferSize(ViUInt32 size) {
+  this->status =
+      viSetBuf(this->instrument, VI_IO_IN_BUF | VI_IO_OUT_BUF, size);
+  if (this->status < VI_SUCCESS) {
+    viStatusDesc(this->resource_manager, this->status, this->buffer);
+    spdlog::error("Error setting buffer size:\n{}\n{}",
+                  this->status,
+                  this->buffer);
+    return false;
+  }
+
+  spdlog::info("I/O buffer size set to {} B", size);
+  return true;
+}
+
+/**
+ * Termination character has to be disabled for binary transfers, otherwise
+ * any 0x0A sample ends the read. ReadBlock does it for the block only.
+ */
+bool InstrumentControl::SetTermCharEnabled(bool enabled) {
+  this->status = viSetAttribute(
+      this->instrument, VI_ATTR_TERMCHAR_EN, enabled ? VI_TRUE : VI_FALSE);
+  if (this->status < VI_SUCCESS) {
+    viStatusDesc(this->resource_manager, this->status, this->buffer);
+    spdlog::error("Error setting termination character handling:\n{}\n{}",
+                  this->status,
+                  this->buffer);
+    return false;
+  }
+  return true;
+}
+
+ViUInt16 InstrumentControl::GetInterfaceType() {
+  ViUInt16 interface_type = 0;
+  this->status =
+      viGetAttribute(this->instrument, VI_ATTR_INTF_TYPE, &interface_type);
+  if (this->status < VI_SUCCESS) {
+    spdlog::warn("Could not read interface type: {}", this->status);
+  }
+  return interface_type;
+}
+
+/**
+ * Routes operation complete to a service request: OPC sets ESR bit 0,
+ * enabled in ESE it raises ESB in the status byte, enabled in SRE it
+ * asserts SRQ. VISA queues the SRQ events for WaitForServiceRequest.
+ */
+bool InstrumentControl::EnableServiceRequest() {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  if (this->service_request_enabled) {
+    return true;
+  }
+  if (this->service_request_unsupported) {
+    return false;
+  }
+
+  std::string command = "*CLS;*ESE " + std::to_string(ESE_OPC_BIT) +
+                        ";*SRE " + std::to_string(STB_ESB_BIT);
+  if (!Write(command.c_str())) {
+    return false;
+  }
+
+  this->status = viEnableEvent(
+      this->instrument, VI_EVENT_SERVICE_REQ, VI_QUEUE, VI_NULL);
+  if (this->status < VI_SUCCESS) {
+    viStatusDesc(this->resource_manager, this->status, this->buffer);
+    spdlog::warn("Service requests not available, operation complete is "
+                 "polled with *OPC? instead:\n{}\n{}",
+                 this->status,
+                 this->buffer);
+    this->service_request_unsupported = true;
+    return false;
+  }
+
+  this->service_request_enabled = true;
+  spdlog::info("Service request on operation complete enabled");
+  return true;
+}
+
+/**
+ * Blocks until instrument asserts SRQ or timeout expires. IO mutex is not
+ * held while waiting so other commands can be sent in the meantime.
+ */
+bool InstrumentControl::WaitForServiceRequest(ViUInt32 timeout) {
+  ViSession session;
+  unsigned generation;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+    session = this->instrument;
+    generation = this->session_generation;
+  }
+  return WaitForServiceRequestInSession(timeout, session, generation);
+}
+
+/**
+ * Writes command and waits until the instrument reports operation
+ * complete. Links without service requests (raw sockets, serial) wait on
+ * *OPC? instead, holding the session for the whole operation.
+ */
+bool InstrumentControl::WriteAndWait(const char *scpi_command,
+                                     ViUInt32 timeout) {
+  return WriteAndWaitInSession(
+      scpi_command, timeout, this->session_generation);
+}
+
+/**
+ * Queues command for the notify thread, which writes it and calls
+ * callback once instrument reports operation complete (true) or the wait
+ * times out (false). Returns immediately, operations are waited for in
+ * the order they were queued.
+ */
+void InstrumentControl::WriteAndNotify(const char *scpi_command,
+                                       std::function<void(bool)> callback,
+                                       ViUInt32 timeout) {
+  {
+    std::lock_guard<std::mutex> lock(this->notify_mutex);
+    if (!this->notify_thread.joinable()) {
+      this->notify_thread = std::thread(&InstrumentControl::NotifyLoop, this);
+    }
+    this->notify_queue.push_back({scpi_command,
+                                  std::move(callback),
+                                  timeout,
+                                  this->session_generation});
+  }
+  this->notify_condition.notify_one();
+}
+
+void InstrumentControl::ApplyTransferProfile(const TransferProfile &profile) {
+  // profile is read by acquisition threads
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  SetBufferSize(profile.buffer_size);
+  SetTimeout(profile.base_timeout_ms);
+
+  this->transfer_profile = profile;
+  this->transfer_profile_active = true;
+  spdlog::info("Transfer profile applied: chunk {} B, buffer {} B, timeout "
+               "{} ms + {:.1f} ms/MB, sample width {} B",
+               profile.chunk_size,
+               profile.buffer_size,
+               profile.base_timeout_ms,
+               profile.timeout_ms_per_mb,
+               profile.sample_width);
+}
+
+// copy is made under the lock, profile can be replaced on connect
+TransferProfile InstrumentControl::GetTransferProfile() {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  return this->transfer_profile;
+}
+
+ViUInt32 InstrumentControl::TimeoutForRecord(size_t record_bytes) {
+  std::lock_guard<std::recursive_mutex> lock(this->io_mutex);
+  return this->transfer_profile.base_timeout_ms +
+         (ViUInt32)(this->transfer_profile.timeout_ms_per_mb * record_bytes /
+                    1e6);
+}
+
+/**
+ * Keeps other threads off the instrument while the returned lock is held,
+ * for command sequences that must not be interleaved (e.g. waveform source
+ * selection followed by preamble and data queries).
+ */
+std::unique_lock<std::recursive_mutex> InstrumentControl::LockSession() {
+  return std::unique_lock<std::recursive_mutex>(this->io_mutex);
+}
+
 /*
  * PUBLIC METHODS END
  */
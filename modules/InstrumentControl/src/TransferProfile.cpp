@@ -0,0 +1,78 @@
+/*********************************************************************
+ * \file   TransferProfile.cpp
+ * \brief  Definition of TransferProfileStore class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TransferProfile.hpp"
+#include <spdlog/spdlog.h>
+
+namespace InstrumentControl {
+TransferProfileStore::TransferProfileStore(std::string filename)
+    : filename(std::move(filename)) {}
+
+bool TransferProfileStore::Load() {
+  std::ifstream file(this->filename);
+  if (!file.is_open()) {
+    spdlog::debug("No transfer profiles in {}", this->filename);
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    TransferProfile profile;
+    std::stringstream fields(line);
+
+    if (!std::getline(fields, profile.instrument_id, '\t')) {
+      continue;
+    }
+    fields >> profile.interface_type >> profile.chunk_size >>
+        profile.buffer_size >> profile.base_timeout_ms >>
+        profile.timeout_ms_per_mb >> profile.sample_width >>
+        profile.throughput_mb_s;
+    if (fields.fail()) {
+      spdlog::warn("Skipping malformed transfer profile: {}", line);
+      continue;
+    }
+    Store(profile);
+  }
+
+  spdlog::info("Loaded {} transfer profiles from {}",
+               this->profiles.size(),
+               this->filename);
+  return true;
+}
+
+bool TransferProfileStore::Save() {
+  std::ofstream file(this->filename, std::ios::trunc);
+  if (!file.is_open()) {
+    spdlog::error("Could not write transfer profiles to {}", this->filename);
+    return false;
+  }
+
+  for (const auto &[key, profile] : this->profiles) {
+    file << profile.instrument_id << '\t' << profile.interface_type << '\t'
+         << profile.chunk_size << '\t' << profile.buffer_size << '\t'
+         << profile.base_timeout_ms << '\t' << profile.timeout_ms_per_mb
+         << '\t' << profile.sample_width << '\t' << profile.throughput_mb_s
+         << '\n';
+  }
+  return true;
+}
+
+bool TransferProfileStore::Find(const std::string &instrument_id,
+                                ViUInt16 interface_type,
+                                TransferProfile &profile) {
+  auto it = this->profiles.find({instrument_id, interface_type});
+  if (it == this->profiles.end()) {
+    return false;
+  }
+  profile = it->second;
+  return true;
+}
+
+void TransferProfileStore::Store(const TransferProfile &profile) {
+  this->profiles[{profile.instrument_id, profile.interface_type}] = profile;
+}
+} // namespace InstrumentControl
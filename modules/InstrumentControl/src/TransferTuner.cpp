@@ -0,0 +1,202 @@
+/*********************************************************************
+ * \file   TransferTuner.cpp
+ * \brief  Definition of TransferTuner class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TransferTuner.hpp"
+#include <cmath>
+
+namespace InstrumentControl {
+using Clock = std::chrono::steady_clock;
+
+// generous timeout so slow candidates are measured instead of timing out
+constexpr ViUInt32 TUNING_TIMEOUT_MS = 10000;
+constexpr ViUInt32 MIN_BASE_TIMEOUT_MS = 200;
+constexpr double TIMEOUT_SAFETY_FACTOR = 2.0;
+
+TransferTuner::TransferTuner(InstrumentControl &scope) : scope(scope) {}
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+std::vector<ViUInt32>
+TransferTuner::CandidateChunkSizes(ViUInt16 interface_type) {
+  switch (interface_type) {
+  case VI_INTF_ASRL:
+    return {256, 1024, 4096};
+  case VI_INTF_GPIB:
+    return {1024, 4096, 16384, 65536};
+  case VI_INTF_USB:
+    return {4096, 16384, 65536, 262144, 1048576};
+  case VI_INTF_TCPIP:
+  default:
+    return {16384, 65536, 262144, 1048576};
+  }
+}
+
+std::vector<ViUInt32>
+TransferTuner::CandidateBufferSizes(ViUInt16 interface_type) {
+  switch (interface_type) {
+  case VI_INTF_ASRL:
+    return {1024, 4096};
+  case VI_INTF_GPIB:
+    return {4096, 65536};
+  case VI_INTF_USB:
+  case VI_INTF_TCPIP:
+  default:
+    return {4096, 65536, 1048576};
+  }
+}
+
+double TransferTuner::MeasureQueryLatencyMs() {
+  constexpr int repetitions = 5;
+  auto start = Clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    scope.Query("*OPC?");
+  }
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+             .count() /
+         repetitions;
+}
+
+/**
+ * Other threads may use the instrument between candidates, so timeout and
+ * buffer size of the candidate are set and restored while the session is
+ * locked.
+ */
+bool TransferTuner::MeasureBlockRead(const TuningRequest &request,
+                                     ViUInt32 chunk_size,
+                                     ViUInt32 buffer_size,
+                                     double &throughput_mb_s,
+                                     size_t &record_bytes) {
+  std::vector<ViByte> block;
+  size_t total_bytes = 0;
+  auto session = scope.LockSession();
+  const ViUInt32 previous_timeout = scope.GetTimeout();
+  const ViUInt32 previous_buffer_size = scope.GetTransferProfile().buffer_size;
+  auto restore = [&]() {
+    scope.SetBufferSize(previous_buffer_size);
+    scope.SetTimeout(previous_timeout);
+  };
+  if (!scope.SetBufferSize(buffer_size)) {
+    restore();
+    return false;
+  }
+  scope.SetTimeout(TUNING_TIMEOUT_MS);
+  scope.Write(request.format_byte_command.c_str());
+
+  auto start = Clock::now();
+  for (int i = 0; i < request.reads_per_candidate; i++) {
+    if (!scope.Write(request.data_query.c_str()) ||
+        !scope.ReadBlock(block, chunk_size)) {
+      scope.ViClear();
+      restore();
+      return false;
+    }
+    total_bytes += block.size();
+  }
+  double elapsed_s =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  restore();
+
+  if (total_bytes == 0 || elapsed_s <= 0.0) {
+    return false;
+  }
+  throughput_mb_s = total_bytes / elapsed_s / 1e6;
+  record_bytes = block.size();
+  return true;
+}
+/*
+ *   PRIVATE METHODS END
+ */
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+TransferProfile TransferTuner::Tune(const TuningRequest &request) {
+  TransferProfile profile;
+  profile.instrument_id = scope.GetIDString();
+  profile.interface_type = scope.GetInterfaceType();
+
+  // chunk sizes are compared with the same buffer size
+  const std::vector<ViUInt32> buffer_sizes =
+      CandidateBufferSizes(profile.interface_type);
+  profile.buffer_size = buffer_sizes.front();
+
+  size_t record_bytes = 0;
+  for (ViUInt32 chunk_size : CandidateChunkSizes(profile.interface_type)) {
+    double throughput_mb_s = 0.0;
+    size_t candidate_record_bytes = 0;
+    if (!MeasureBlockRead(request,
+                          chunk_size,
+                          profile.buffer_size,
+                          throughput_mb_s,
+                          candidate_record_bytes)) {
+      spdlog::warn("Tuning: chunk size {} B failed", chunk_size);
+      continue;
+    }
+    spdlog::info(
+        "Tuning: chunk size {} B - {:.3f} MB/s", chunk_size, throughput_mb_s);
+
+    if (throughput_mb_s > profile.throughput_mb_s) {
+      profile.throughput_mb_s = throughput_mb_s;
+      profile.chunk_size = chunk_size;
+      record_bytes = candidate_record_bytes;
+    }
+  }
+
+  for (size_t i = 1; i < buffer_sizes.size() && profile.throughput_mb_s > 0.0;
+       i++) {
+    double throughput_mb_s = 0.0;
+    size_t candidate_record_bytes = 0;
+    if (!MeasureBlockRead(request,
+                          profile.chunk_size,
+                          buffer_sizes[i],
+                          throughput_mb_s,
+                          candidate_record_bytes)) {
+      spdlog::warn("Tuning: buffer size {} B failed", buffer_sizes[i]);
+      continue;
+    }
+    spdlog::info("Tuning: buffer size {} B - {:.3f} MB/s",
+                 buffer_sizes[i],
+                 throughput_mb_s);
+
+    if (throughput_mb_s > profile.throughput_mb_s) {
+      profile.throughput_mb_s = throughput_mb_s;
+      profile.buffer_size = buffer_sizes[i];
+    }
+  }
+
+  if (profile.throughput_mb_s <= 0.0) {
+    spdlog::error("Tuning failed, no waveform could be read");
+    return profile;
+  }
+
+  const double latency_ms = MeasureQueryLatencyMs();
+  profile.base_timeout_ms =
+      std::max(MIN_BASE_TIMEOUT_MS,
+               (ViUInt32)std::ceil(TIMEOUT_SAFETY_FACTOR * 2 * latency_ms));
+  profile.timeout_ms_per_mb =
+      TIMEOUT_SAFETY_FACTOR * 1000.0 / profile.throughput_mb_s;
+
+  // smallest width satisfying precision floor, WORD if link has headroom
+  profile.sample_width = request.precision_floor_bits > 8 ? 2 : 1;
+  const double word_record_ms =
+      latency_ms + 2.0 * record_bytes / (profile.throughput_mb_s * 1e3);
+  if (profile.sample_width == 1 && word_record_ms <= request.frame_budget_ms) {
+    profile.sample_width = 2;
+  }
+  scope.Write(profile.sample_width == 2 ? request.format_word_command.c_str()
+                                        : request.format_byte_command.c_str());
+
+  spdlog::info("Tuning finished for {}: {:.3f} MB/s",
+               profile.instrument_id,
+               profile.throughput_mb_s);
+  return profile;
+}
+/*
+ * PUBLIC METHODS END
+ */
+} // namespace InstrumentControl
@@ -0,0 +1,76 @@
+/*********************************************************************
+ * \file   TransferProfileTest.cpp
+ * \brief  Unit tests of TransferProfileStore
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TestSupport.hpp"
+#include "TransferProfile.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace InstrumentControl;
+
+static const std::string FILENAME =
+    (std::filesystem::temp_directory_path() / "TransferProfileTest.txt")
+        .string();
+static const std::string ID = "KEYSIGHT TECHNOLOGIES,DSOX1204G,CN1,2.10";
+
+static TransferProfile makeProfile(ViUInt16 interface_type,
+                                   ViUInt32 chunk_size) {
+  TransferProfile profile;
+  profile.instrument_id = ID;
+  profile.interface_type = interface_type;
+  profile.chunk_size = chunk_size;
+  profile.buffer_size = 65536;
+  profile.base_timeout_ms = 250;
+  profile.timeout_ms_per_mb = 120.5;
+  profile.sample_width = 2;
+  profile.throughput_mb_s = 16.5;
+  return profile;
+}
+
+// profile tuned over one interface is not used over another
+static void testProfilePerInterface() {
+  std::filesystem::remove(FILENAME);
+  {
+    TransferProfileStore store(FILENAME);
+    store.Store(makeProfile(VI_INTF_USB, 262144));
+    store.Store(makeProfile(VI_INTF_TCPIP, 65536));
+    CHECK(store.Save());
+  }
+
+  TransferProfileStore store(FILENAME);
+  CHECK(store.Load());
+  TransferProfile profile;
+  CHECK(store.Find(ID, VI_INTF_USB, profile));
+  CHECK(profile.chunk_size == 262144);
+  CHECK(profile.buffer_size == 65536);
+  CHECK(profile.sample_width == 2);
+  CHECK_NEAR(profile.timeout_ms_per_mb, 120.5, 1e-9);
+  CHECK(store.Find(ID, VI_INTF_TCPIP, profile));
+  CHECK(profile.chunk_size == 65536);
+  CHECK(!store.Find(ID, VI_INTF_GPIB, profile));
+  CHECK(!store.Find("OTHER", VI_INTF_USB, profile));
+}
+
+static void testMalformedLineSkipped() {
+  {
+    std::ofstream file(FILENAME, std::ios::trunc);
+    file << "BROKEN\tnot numbers\n";
+    file << ID << "\t7\t4096\t4096\t200\t50\t1\t2.5\n";
+  }
+  TransferProfileStore store(FILENAME);
+  CHECK(store.Load());
+  TransferProfile profile;
+  CHECK(!store.Find("BROKEN", 0, profile));
+  CHECK(store.Find(ID, 7, profile) && profile.chunk_size == 4096);
+  std::filesystem::remove(FILENAME);
+}
+
+int main() {
+  testProfilePerInterface();
+  testMalformedLineSkipped();
+  return TestSupport::Result();
+}
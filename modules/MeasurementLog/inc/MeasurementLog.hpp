@@ -0,0 +1,58 @@
+/*********************************************************************
+ * \file   MeasurementLog.hpp
+ * \brief  Named measurement series persisted as appended binary segments
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "TimeSeries.hpp"
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace MeasurementLog {
+constexpr uint32_t SEGMENT_MAGIC = 0x4D4C5331; // "MLS1"
+// samples buffered per series before a segment is written
+constexpr size_t SEGMENT_SAMPLES = 4096;
+// buffered samples are written at least this often
+constexpr int64_t SEGMENT_MAX_AGE_MS = 60 * 1000;
+
+/**
+ * Series are kept in memory as TimeSeries and appended to one log file in
+ * segments (host byte order):
+ *   u32 magic, u16 name length, name, u32 sample count, i64 base time ms,
+ *   count x {u32 time offset ms, f32 value}
+ * Loading replays segments into the series, a truncated last segment
+ * (e.g. after power loss) is cut off the file, so new segments are
+ * appended after the last complete one.
+ */
+class MeasurementLog {
+public:
+  explicit MeasurementLog(std::string filename = "measurements.bin");
+  ~MeasurementLog();
+
+  bool Load();
+  bool Flush();
+  bool FlushExpired(int64_t now_ms);
+  void Append(const std::string &name, int64_t time_ms, float value);
+
+  std::vector<std::string> SeriesNames() const;
+  const TimeSeries *Find(const std::string &name) const;
+
+private:
+  struct Series {
+    TimeSeries data;
+    std::vector<Sample> pending; // not yet written to file
+  };
+
+  bool FlushSeries(const std::string &name, Series &series);
+  bool WriteSegment(std::ofstream &file,
+                    const std::string &name,
+                    std::vector<Sample> &samples);
+
+  std::string filename;
+  std::map<std::string, Series> series;
+};
+} // namespace MeasurementLog
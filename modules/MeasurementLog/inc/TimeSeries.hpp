@@ -0,0 +1,113 @@
+/*********************************************************************
+ * \file   TimeSeries.hpp
+ * \brief  Bounded series of measurement samples with rollups at coarser
+ *         resolutions
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace MeasurementLog {
+struct Sample {
+  int64_t time_ms = 0; // since epoch
+  float value = 0.0f;
+};
+
+/**
+ * Summary of samples in one period. Raw samples are returned by queries as
+ * rollups of a single sample.
+ */
+struct Rollup {
+  int64_t start_ms = 0;
+  float min = std::numeric_limits<float>::infinity();
+  float max = -std::numeric_limits<float>::infinity();
+  double sum = 0.0;
+  uint32_t count = 0;
+
+  void Add(float value);
+  float Mean() const;
+};
+
+enum class Resolution { Raw, Second, Minute, Hour };
+constexpr size_t RESOLUTION_COUNT = 4;
+
+// number of entries kept per resolution
+struct TimeSeriesCapacity {
+  size_t raw = 65536;
+  size_t seconds = 86400; // 1 day
+  size_t minutes = 43200; // 30 days
+  size_t hours = 8760;    // 1 year
+};
+
+/**
+ * Entries oldest first, storage grows with them up to capacity, then the
+ * oldest ones are overwritten.
+ */
+template <typename T> class Ring {
+public:
+  explicit Ring(size_t capacity = 1)
+      : capacity(std::max<size_t>(capacity, 1)) {}
+
+  void Push(const T &entry) {
+    if (this->entries.size() < this->capacity) {
+      this->entries.push_back(entry);
+      return;
+    }
+    this->entries[this->head] = entry;
+    this->head = (this->head + 1) % this->capacity;
+  }
+
+  // index 0 is the oldest entry kept
+  const T &operator[](size_t index) const {
+    return this->entries[(this->head + index) % this->entries.size()];
+  }
+
+  size_t Size() const { return this->entries.size(); }
+  bool Full() const { return this->entries.size() == this->capacity; }
+
+private:
+  std::vector<T> entries;
+  size_t capacity;
+  size_t head = 0; // oldest entry once full
+};
+
+/**
+ * Raw samples and 1 s, 1 min, 1 h rollups are kept in bounded rings, so
+ * memory use does not depend on how long the series is fed, and short
+ * series do not take the memory of full rings. Rollups are updated on
+ * every append, a query picks the finest resolution that still covers the
+ * requested span within the point budget.
+ */
+class TimeSeries {
+public:
+  explicit TimeSeries(
+      const TimeSeriesCapacity &capacity = TimeSeriesCapacity());
+
+  bool Append(int64_t time_ms, float value);
+  std::vector<Rollup> Query(int64_t from_ms,
+                            int64_t to_ms,
+                            size_t max_points,
+                            Resolution &resolution) const;
+
+  size_t Size(Resolution resolution) const;
+  int64_t LastTime() const;
+
+private:
+  struct Level {
+    int64_t period_ms = 0;
+    Ring<Rollup> ring;
+    Rollup current; // period still being filled, not in ring yet
+  };
+
+  Ring<Sample> raw;
+  std::array<Level, RESOLUTION_COUNT - 1> levels; // second, minute, hour
+  int64_t last_time_ms = std::numeric_limits<int64_t>::min();
+};
+} // namespace MeasurementLog
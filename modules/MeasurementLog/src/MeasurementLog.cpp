@@ -0,0 +1,210 @@
+/*********************************************************************
+ * \file   MeasurementLog.cpp
+ * \brief  Definition of MeasurementLog class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "MeasurementLog.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <spdlog/spdlog.h>
+
+namespace MeasurementLog {
+MeasurementLog::MeasurementLog(std::string filename)
+    : filename(std::move(filename)) {}
+
+MeasurementLog::~MeasurementLog() {
+  Flush();
+}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+bool MeasurementLog::Load() {
+  std::ifstream file(this->filename, std::ios::binary);
+  if (!file.is_open()) {
+    spdlog::debug("No measurement log in {}", this->filename);
+    return false;
+  }
+  // whole file is read at once, segments are parsed from memory
+  std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+
+  size_t offset = 0;
+  size_t valid_bytes = 0; // end of the last complete segment
+  size_t samples = 0;
+  auto read = [&](void *destination, size_t size) {
+    if (offset + size > bytes.size()) {
+      return false;
+    }
+    std::memcpy(destination, bytes.data() + offset, size);
+    offset += size;
+    return true;
+  };
+  while (offset < bytes.size()) {
+    uint32_t magic = 0;
+    uint16_t name_length = 0;
+    uint32_t count = 0;
+    int64_t base_time_ms = 0;
+    if (!read(&magic, sizeof(magic)) || magic != SEGMENT_MAGIC ||
+        !read(&name_length, sizeof(name_length)) ||
+        offset + name_length > bytes.size()) {
+      break;
+    }
+    std::string name(bytes.data() + offset, name_length);
+    offset += name_length;
+    if (!read(&count, sizeof(count)) ||
+        !read(&base_time_ms, sizeof(base_time_ms)) ||
+        offset + (size_t)count * 8 > bytes.size()) {
+      break;
+    }
+
+    TimeSeries &series = this->series[name].data;
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t time_offset = 0;
+      float value = 0.0f;
+      read(&time_offset, sizeof(time_offset));
+      read(&value, sizeof(value));
+      series.Append(base_time_ms + time_offset, value);
+    }
+    samples += count;
+    valid_bytes = offset;
+  }
+  file.close();
+  if (valid_bytes < bytes.size()) {
+    // segments appended later must not follow the damaged one, next load
+    // would read them as its remainder
+    std::error_code error;
+    std::filesystem::resize_file(this->filename, valid_bytes, error);
+    if (error) {
+      spdlog::error("Measurement log {} damaged at byte {} and could not "
+                    "be truncated: {}",
+                    this->filename,
+                    valid_bytes,
+                    error.message());
+      return false;
+    }
+    spdlog::warn("Measurement log {} damaged at byte {}, truncated",
+                 this->filename,
+                 valid_bytes);
+  }
+
+  spdlog::info("Loaded {} samples of {} series from {}",
+               samples,
+               this->series.size(),
+               this->filename);
+  return true;
+}
+
+bool MeasurementLog::Flush() {
+  bool success = true;
+  for (auto &[name, series] : this->series) {
+    success = FlushSeries(name, series) && success;
+  }
+  return success;
+}
+
+/**
+ * Writes series whose oldest buffered sample is SEGMENT_MAX_AGE_MS old,
+ * for callers appending rarely or not at all, e.g. on a poll timer.
+ */
+bool MeasurementLog::FlushExpired(int64_t now_ms) {
+  bool success = true;
+  for (auto &[name, series] : this->series) {
+    if (!series.pending.empty() &&
+        now_ms - series.pending.front().time_ms >= SEGMENT_MAX_AGE_MS) {
+      success = FlushSeries(name, series) && success;
+    }
+  }
+  return success;
+}
+
+void MeasurementLog::Append(const std::string &name,
+                            int64_t time_ms,
+                            float value) {
+  Series &series = this->series[name];
+  if (!series.data.Append(time_ms, value)) {
+    return;
+  }
+  // time offsets in a segment stay small
+  if (!series.pending.empty() &&
+      time_ms - series.pending.front().time_ms >= SEGMENT_MAX_AGE_MS) {
+    FlushSeries(name, series);
+  }
+  series.pending.push_back({time_ms, value});
+  if (series.pending.size() >= SEGMENT_SAMPLES) {
+    FlushSeries(name, series);
+  }
+}
+
+std::vector<std::string> MeasurementLog::SeriesNames() const {
+  std::vector<std::string> names;
+  for (const auto &entry : this->series) {
+    names.push_back(entry.first);
+  }
+  return names;
+}
+
+const TimeSeries *MeasurementLog::Find(const std::string &name) const {
+  auto it = this->series.find(name);
+  return it == this->series.end() ? nullptr : &it->second.data;
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+bool MeasurementLog::FlushSeries(const std::string &name, Series &series) {
+  if (series.pending.empty()) {
+    return true;
+  }
+  std::ofstream file(this->filename, std::ios::binary | std::ios::app);
+  if (!file.is_open()) {
+    spdlog::error("Could not write measurement log {}", this->filename);
+    return false;
+  }
+  return WriteSegment(file, name, series.pending);
+}
+
+bool MeasurementLog::WriteSegment(std::ofstream &file,
+                                  const std::string &name,
+                                  std::vector<Sample> &samples) {
+  const uint16_t name_length = (uint16_t)std::min<size_t>(name.size(), 65535);
+  const uint32_t count = (uint32_t)samples.size();
+  const int64_t base_time_ms = samples.front().time_ms;
+
+  // segment is assembled first and written with one call
+  std::vector<char> segment;
+  segment.reserve(18 + name_length + samples.size() * 8);
+  auto append = [&](const void *source, size_t size) {
+    const char *bytes = (const char *)source;
+    segment.insert(segment.end(), bytes, bytes + size);
+  };
+  append(&SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+  append(&name_length, sizeof(name_length));
+  append(name.data(), name_length);
+  append(&count, sizeof(count));
+  append(&base_time_ms, sizeof(base_time_ms));
+  for (const Sample &sample : samples) {
+    const uint32_t time_offset = (uint32_t)(sample.time_ms - base_time_ms);
+    append(&time_offset, sizeof(time_offset));
+    append(&sample.value, sizeof(sample.value));
+  }
+
+  file.write(segment.data(), segment.size());
+  file.flush();
+  if (!file) {
+    spdlog::error("Error writing measurement log {}", this->filename);
+    return false;
+  }
+  samples.clear();
+  return true;
+}
+/*
+ *   PRIVATE METHODS END
+ */
+} // namespace MeasurementLog
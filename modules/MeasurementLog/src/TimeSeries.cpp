@@ -0,0 +1,156 @@
+/*********************************************************************
+ * \file   TimeSeries.cpp
+ * \brief  Definition of TimeSeries class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TimeSeries.hpp"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace MeasurementLog {
+static int64_t startOf(const Sample &sample) {
+  return sample.time_ms;
+}
+
+static int64_t startOf(const Rollup &rollup) {
+  return rollup.start_ms;
+}
+
+// first entry starting at or after time_ms
+template <typename T>
+static size_t lowerBound(const Ring<T> &ring, int64_t time_ms) {
+  size_t low = 0;
+  size_t high = ring.Size();
+  while (low < high) {
+    const size_t middle = (low + high) / 2;
+    if (startOf(ring[middle]) < time_ms) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+// ring lost no entries, or still has data from time_ms
+template <typename T>
+static bool covers(const Ring<T> &ring, int64_t time_ms) {
+  return !ring.Full() || startOf(ring[0]) <= time_ms;
+}
+
+void Rollup::Add(float value) {
+  this->min = std::min(this->min, value);
+  this->max = std::max(this->max, value);
+  this->sum += value;
+  this->count++;
+}
+
+float Rollup::Mean() const {
+  return this->count > 0 ? (float)(this->sum / this->count) : 0.0f;
+}
+
+TimeSeries::TimeSeries(const TimeSeriesCapacity &capacity)
+    : raw(capacity.raw) {
+  const size_t sizes[] = {capacity.seconds, capacity.minutes, capacity.hours};
+  const int64_t periods[] = {1000, 60 * 1000, 3600 * 1000};
+  for (size_t i = 0; i < this->levels.size(); i++) {
+    this->levels[i].period_ms = periods[i];
+    this->levels[i].ring = Ring<Rollup>(sizes[i]);
+  }
+}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+/**
+ * Adds a sample. Samples older than the last one are rejected, rollups
+ * assume time only moves forward.
+ */
+bool TimeSeries::Append(int64_t time_ms, float value) {
+  if (time_ms < this->last_time_ms) {
+    spdlog::warn("Sample at {} ms older than last one, skipped", time_ms);
+    return false;
+  }
+  this->last_time_ms = time_ms;
+  this->raw.Push({time_ms, value});
+
+  for (Level &level : this->levels) {
+    const int64_t start = time_ms - time_ms % level.period_ms;
+    if (level.current.count > 0 && level.current.start_ms != start) {
+      level.ring.Push(level.current);
+      level.current = Rollup();
+    }
+    level.current.start_ms = start;
+    level.current.Add(value);
+  }
+  return true;
+}
+
+/**
+ * Returns entries of [from_ms, to_ms] at the finest resolution that has
+ * at most max_points of them and still keeps data from from_ms. If none
+ * does, the coarsest resolution is used. Entries are oldest first.
+ */
+std::vector<Rollup> TimeSeries::Query(int64_t from_ms,
+                                      int64_t to_ms,
+                                      size_t max_points,
+                                      Resolution &resolution) const {
+  const size_t raw_begin = lowerBound(this->raw, from_ms);
+  const size_t raw_end = lowerBound(this->raw, to_ms + 1);
+  if (raw_end - raw_begin <= max_points && covers(this->raw, from_ms)) {
+    resolution = Resolution::Raw;
+    std::vector<Rollup> entries(raw_end - raw_begin);
+    for (size_t index = raw_begin; index < raw_end; index++) {
+      Rollup &entry = entries[index - raw_begin];
+      entry.start_ms = this->raw[index].time_ms;
+      entry.Add(this->raw[index].value);
+    }
+    return entries;
+  }
+
+  for (size_t i = 0; i < this->levels.size(); i++) {
+    const Level &level = this->levels[i];
+    // the period containing from_ms may start before it
+    const int64_t first_start = from_ms - level.period_ms + 1;
+    const size_t begin = lowerBound(level.ring, first_start);
+    const size_t end = lowerBound(level.ring, to_ms + 1);
+    const bool current = level.current.count > 0 &&
+                         level.current.start_ms >= first_start &&
+                         level.current.start_ms <= to_ms;
+    const size_t count = end - begin + (current ? 1 : 0);
+    if ((count > max_points || !covers(level.ring, from_ms)) &&
+        i + 1 < this->levels.size()) {
+      continue;
+    }
+
+    resolution = static_cast<Resolution>(i + 1);
+    std::vector<Rollup> entries;
+    entries.reserve(count);
+    for (size_t index = begin; index < end; index++) {
+      entries.push_back(level.ring[index]);
+    }
+    if (current) {
+      entries.push_back(level.current);
+    }
+    return entries;
+  }
+  return {};
+}
+
+size_t TimeSeries::Size(Resolution resolution) const {
+  if (resolution == Resolution::Raw) {
+    return this->raw.Size();
+  }
+  const Level &level = this->levels[static_cast<size_t>(resolution) - 1];
+  return level.ring.Size() + (level.current.count > 0 ? 1 : 0);
+}
+
+int64_t TimeSeries::LastTime() const {
+  return this->last_time_ms;
+}
+/*
+ * PUBLIC METHODS END
+ */
+} // namespace MeasurementLog
@@ -0,0 +1,97 @@
+/*********************************************************************
+ * \file   MeasurementLogTest.cpp
+ * \brief  Unit tests of MeasurementLog persistence
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "MeasurementLog.hpp"
+#include "TestSupport.hpp"
+#include <filesystem>
+
+static const std::string FILENAME =
+    (std::filesystem::temp_directory_path() / "MeasurementLogTest.bin")
+        .string();
+constexpr int64_t START_MS = 1760000000000;
+
+static size_t rawSize(const MeasurementLog::MeasurementLog &log,
+                      const std::string &name) {
+  const MeasurementLog::TimeSeries *series = log.Find(name);
+  return series ? series->Size(MeasurementLog::Resolution::Raw) : 0;
+}
+
+static void appendSamples(MeasurementLog::MeasurementLog &log,
+                          const std::string &name,
+                          int64_t first_ms,
+                          size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    log.Append(name, first_ms + 1000 * i, 1.0f + i);
+  }
+  CHECK(log.Flush());
+}
+
+static void testReload() {
+  std::filesystem::remove(FILENAME);
+  {
+    MeasurementLog::MeasurementLog log(FILENAME);
+    appendSamples(log, "a", START_MS, 10);
+    appendSamples(log, "b", START_MS, 5);
+  }
+  MeasurementLog::MeasurementLog log(FILENAME);
+  CHECK(log.Load());
+  CHECK(log.SeriesNames().size() == 2);
+  CHECK(rawSize(log, "a") == 10);
+  CHECK(rawSize(log, "b") == 5);
+}
+
+// segments appended after a damaged one must survive the next load
+static void testAppendAfterTruncation() {
+  std::filesystem::remove(FILENAME);
+  {
+    MeasurementLog::MeasurementLog log(FILENAME);
+    appendSamples(log, "a", START_MS, 10);
+    appendSamples(log, "a", START_MS + 10000, 50);
+  }
+  std::filesystem::resize_file(FILENAME,
+                               std::filesystem::file_size(FILENAME) - 5);
+  {
+    MeasurementLog::MeasurementLog log(FILENAME);
+    log.Load();
+    CHECK(rawSize(log, "a") == 10);
+    appendSamples(log, "b", START_MS, 3);
+  }
+  MeasurementLog::MeasurementLog log(FILENAME);
+  CHECK(log.Load());
+  CHECK(rawSize(log, "a") == 10);
+  CHECK(rawSize(log, "b") == 3);
+  std::filesystem::remove(FILENAME);
+}
+
+// samples are written by age even when nothing is appended any more
+static void testFlushExpired() {
+  std::filesystem::remove(FILENAME);
+  {
+    MeasurementLog::MeasurementLog log(FILENAME);
+    log.Append("a", START_MS, 1.0f);
+    log.Append("b", START_MS + 30000, 2.0f);
+    CHECK(log.FlushExpired(START_MS + MeasurementLog::SEGMENT_MAX_AGE_MS));
+    CHECK(std::filesystem::exists(FILENAME));
+
+    MeasurementLog::MeasurementLog reloaded(FILENAME);
+    CHECK(reloaded.Load());
+    CHECK(rawSize(reloaded, "a") == 1);
+    CHECK(rawSize(reloaded, "b") == 0);
+    // remaining samples are written on destruction
+  }
+  MeasurementLog::MeasurementLog log(FILENAME);
+  CHECK(log.Load());
+  CHECK(rawSize(log, "b") == 1);
+  std::filesystem::remove(FILENAME);
+}
+
+int main() {
+  testReload();
+  testAppendAfterTruncation();
+  testFlushExpired();
+  return TestSupport::Result();
+}
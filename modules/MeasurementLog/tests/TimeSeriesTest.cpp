@@ -0,0 +1,83 @@
+/*********************************************************************
+ * \file   TimeSeriesTest.cpp
+ * \brief  Unit tests of TimeSeries rollups and queries
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TestSupport.hpp"
+#include "TimeSeries.hpp"
+
+using namespace MeasurementLog;
+
+constexpr int64_t MINUTE_START_MS = 1759999980000; // whole minute
+
+// 5 minutes of samples every 100 ms, value is the minute number
+static void fillMinutes(TimeSeries &series) {
+  for (int64_t time = 0; time < 5 * 60000; time += 100) {
+    series.Append(MINUTE_START_MS + time, (float)(time / 60000));
+  }
+}
+
+static void testRollups() {
+  TimeSeries series;
+  fillMinutes(series);
+  CHECK(series.Size(Resolution::Raw) == 3000);
+  CHECK(series.Size(Resolution::Second) == 300);
+  CHECK(series.Size(Resolution::Minute) == 5);
+  CHECK(series.Size(Resolution::Hour) == 1);
+  CHECK(!series.Append(MINUTE_START_MS, 0.0f));
+
+  Resolution resolution;
+  auto entries = series.Query(
+      MINUTE_START_MS, MINUTE_START_MS + 5 * 60000, 100, resolution);
+  CHECK(resolution == Resolution::Minute);
+  CHECK(entries.size() == 5);
+  if (entries.size() == 5) {
+    CHECK(entries[3].start_ms == MINUTE_START_MS + 3 * 60000);
+    CHECK(entries[3].count == 600);
+    CHECK_NEAR(entries[3].Mean(), 3.0, 1e-6);
+    CHECK(entries[4].min == 4.0f && entries[4].max == 4.0f);
+  }
+
+  entries = series.Query(
+      MINUTE_START_MS, MINUTE_START_MS + 10000, 1000, resolution);
+  CHECK(resolution == Resolution::Raw);
+  CHECK(entries.size() == 101);
+}
+
+// resolution whose ring lost the start of the span is not used
+static void testCoverage() {
+  TimeSeriesCapacity capacity;
+  capacity.raw = 100;
+  TimeSeries series(capacity);
+  fillMinutes(series);
+  CHECK(series.Size(Resolution::Raw) == 100);
+
+  Resolution resolution;
+  auto entries = series.Query(
+      MINUTE_START_MS, MINUTE_START_MS + 5 * 60000, 1000, resolution);
+  CHECK(resolution == Resolution::Second);
+  CHECK(entries.size() == 300);
+}
+
+// storage grows with entries, then the oldest are overwritten
+static void testRing() {
+  Ring<int> ring(3);
+  CHECK(ring.Size() == 0 && !ring.Full());
+  ring.Push(1);
+  ring.Push(2);
+  CHECK(ring.Size() == 2 && ring[0] == 1 && ring[1] == 2);
+  for (int value = 3; value <= 7; value++) {
+    ring.Push(value);
+  }
+  CHECK(ring.Full() && ring.Size() == 3);
+  CHECK(ring[0] == 5 && ring[1] == 6 && ring[2] == 7);
+}
+
+int main() {
+  testRing();
+  testRollups();
+  testCoverage();
+  return TestSupport::Result();
+}
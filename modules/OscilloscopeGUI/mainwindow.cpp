@@ -42,40 +42,198 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow) {
   ui->setupUi(this);
   setupLogging(ui->logTextEdit);
+
+  // dialect file is watched, edits are applied without reconnecting
+  dialect_reload_timer.setSingleShot(true);
+  dialect_reload_timer.setInterval(DIALECT_RELOAD_DELAY_MS);
+  connect(&dialect_watcher,
+          &QFileSystemWatcher::fileChanged,
+          &dialect_reload_timer,
+          qOverload<>(&QTimer::start));
+  connect(&dialect_reload_timer,
+          &QTimer::timeout,
+          this,
+          &MainWindow::reloadDialect);
+
+  // last used dialect is opened without asking, unchanged files come from
+  // compiled cache
+  QSettings settings(SETTINGS_FILENAME, QSettings::IniFormat);
+  commands_filename = settings.value("dialect").toString();
+  if (commands_filename.isEmpty() || !QFileInfo::exists(commands_filename)) {
+    selectDialect();
+  } else {
+    loadDialect();
+  }
+
+  transfer_profiles.Load();
+  on_HistorySizeSpinBox_valueChanged(ui->HistorySizeSpinBox->value());
+  ui->SpectrumPlot->setDecibelScale(true);
+
+  measurement_log.Load();
+  for (const std::string &name : measurement_log.SeriesNames()) {
+    ui->TrendSeriesComboBox->addItem(QString::fromStdString(name));
+  }
+  connect(&measurement_timer,
+          &QTimer::timeout,
+          this,
+          &MainWindow::pollMeasurements);
+}
+
+MainWindow::~MainWindow() {
+  dialect_reload_timer.stop();
+  if (dialect_reload.valid()) {
+    dialect_reload.wait();
+  }
+  if (transfer_tuning.valid()) {
+    transfer_tuning.wait();
+  }
+  screen_mirror.stop();
+  ui->SpectrumContinuousCheckBox->setChecked(false);
+  if (spectrum_thread.joinable()) {
+    spectrum_thread.join();
+  }
+  delete ui;
+}
+
+void MainWindow::on_AutoscalePushbutton_clicked() {
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("utils.autoscale");
+  ui->AutoscalePushbutton->setEnabled(false);
+  // completion is reported by instrument SRQ, callback comes from worker
+  // thread so GUI is updated in the GUI thread
+  scope.WriteAndNotify(command.c_str(), [this](bool done) {
+    QMetaObject::invokeMethod(this, [this, done]() {
+      if (done) {
+        spdlog::info("Autoscale completed!");
+      } else {
+        spdlog::error("Error setting autoscale");
+      }
+      ui->AutoscalePushbutton->setEnabled(true);
+    });
+  });
+}
+
+void MainWindow::selectDialect() {
   // Open a file dialog to select a .yml file
-  commands_filename = QFileDialog::getOpenFileName(
+  QString filename = QFileDialog::getOpenFileName(
       nullptr,
       "Wybierz plik z komendami SCPI oscyloskopu", // Window title
       QDir::currentPath(),        // Start in the user's home directory
       "YAML Files (*.yml *.yaml)" // File filter to restrict to YAML files
   );
 
-  if (!commands_filename.isEmpty()) {
-    spdlog::info("User selected file: {}", commands_filename.toStdString());
-  } else {
+  if (filename.isEmpty()) {
     spdlog::warn("No file selected.");
+    return;
   }
+  spdlog::info("User selected file: {}", filename.toStdString());
+
+  commands_filename = filename;
+  QSettings settings(SETTINGS_FILENAME, QSettings::IniFormat);
+  settings.setValue("dialect", commands_filename);
+  loadDialect();
 }
 
-MainWindow::~MainWindow() {
-  delete ui;
+void MainWindow::loadDialect() {
+  if (!dialect_watcher.files().isEmpty()) {
+    dialect_watcher.removePaths(dialect_watcher.files());
+  }
+  dialect_watcher.addPath(commands_filename);
+  commands_tree.Load(commands_filename.toStdString());
+  ui->DialectLabel->setText(QFileInfo(commands_filename).fileName());
 }
 
-void MainWindow::on_AutoscalePushbutton_clicked() {
-  auto command = commands_tree.GetCommandTree()["utils"]["autoscale"].val();
-  if (scope.Write((ViChar *)std::string(command.data(), command.len).c_str())) {
-    spdlog::info("Autoscale set!");
-  } else {
-    spdlog::error("Error setting autoscale");
+/**
+ * Parses changed dialect in background. Command table is swapped as a
+ * whole, so running workers finish with the commands they started with
+ * and the instrument session is kept.
+ */
+void MainWindow::reloadDialect() {
+  // editors often save by replacing the file, which drops it from watcher
+  if (!dialect_watcher.files().contains(commands_filename) &&
+      QFileInfo::exists(commands_filename)) {
+    dialect_watcher.addPath(commands_filename);
+  }
+  if (dialect_reload.valid()) {
+    dialect_reload.wait();
   }
+  dialect_reload =
+      std::async(std::launch::async,
+                 [this, filename = commands_filename.toStdString()]() {
+                   if (!commands_tree.Load(filename)) {
+                     spdlog::warn("Previous dialect commands kept");
+                   }
+                 });
 }
 
 void MainWindow::scopeSetup(ViChar scope_string[]) {
   scope.Connect(scope_string);
-  commands_tree.ReadYaml(commands_filename.toUtf8().constData());
+  setupTransferProfile();
+}
+
+void MainWindow::setupTransferProfile() {
+  auto commands = commands_tree.GetCommandTable();
+  if (!commands->HasSection("waveform")) {
+    spdlog::debug("Dialect has no waveform section, transfer not tuned");
+    return;
+  }
+
+  // fill encoding placeholder of waveform format command
+  auto format = commands->Get("waveform.format");
+  auto format_command = [&](const char *width) {
+    return std::regex_replace(
+        format,
+        std::regex("\\{encoding\\}"),
+        commands->Get(std::string("waveform.encodings.") + width));
+  };
+
+  const int precision_floor_bits = ui->PrecisionFloorSpinBox->value();
+  InstrumentControl::TransferProfile profile;
+  if (transfer_profiles.Find(
+          scope.GetIDString(), scope.GetInterfaceType(), profile) &&
+      profile.sample_width * 8 >= precision_floor_bits) {
+    spdlog::info("Using stored transfer profile for {}", scope.GetIDString());
+    scope.ApplyTransferProfile(profile);
+    scope.Write(
+        format_command(profile.sample_width == 2 ? "word" : "byte").c_str());
+    return;
+  }
+
+  if (!ui->AutoTuneCheckBox->isChecked()) {
+    return;
+  }
+  if (transfer_tuning.valid() &&
+      transfer_tuning.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready) {
+    spdlog::warn("Transfer tuning already running");
+    return;
+  }
+
+  InstrumentControl::TuningRequest request;
+  request.data_query = commands->Get("waveform.data");
+  request.format_byte_command = format_command("byte");
+  request.format_word_command = format_command("word");
+  request.precision_floor_bits = precision_floor_bits;
+
+  // reads of up to 1 MB per candidate, the window stays responsive
+  ui->AutoTuneCheckBox->setEnabled(false);
+  transfer_tuning = std::async(std::launch::async, [this, request]() {
+    auto profile = std::make_shared<InstrumentControl::TransferProfile>(
+        InstrumentControl::TransferTuner(scope).Tune(request));
+    QMetaObject::invokeMethod(this, [this, profile]() {
+      ui->AutoTuneCheckBox->setEnabled(true);
+      if (profile->throughput_mb_s > 0.0) {
+        scope.ApplyTransferProfile(*profile);
+        transfer_profiles.Store(*profile);
+        transfer_profiles.Save();
+      }
+    });
+  });
 }
 
 void MainWindow::on_DisconnectPushButton_clicked() {
+  ui->ScreenMirrorCheckBox->setChecked(false);
+  ui->TrendPollCheckBox->setChecked(false);
   scope.Disconnect();
   ui->ConnectPushButton->setEnabled(true);
 }
@@ -85,32 +243,36 @@ void MainWindow::on_ConnectPushButton_clicked() {
   ui->ConnectPushButton->setEnabled(false);
 }
 
+void MainWindow::on_DialectPushButton_clicked() {
+  selectDialect();
+}
+
 void MainWindow::on_FrequencyPushbutton_clicked() {
-  ViChar *result;
+  auto commands = commands_tree.GetCommandTable();
   std::tuple<double, int> result_to_display;
-  auto set_meas_type_command =
-      commands_tree.GetCommandTree()["measurements"]["frequency"].val();
-  auto get_meas_result_command =
-      commands_tree.GetCommandTree()["measurements"]["get_result"].val();
+  auto set_meas_type_command = commands->Get("measurements.frequency");
+  auto get_meas_result_command = commands->Get("measurements.get_result");
   std::string command_to_write;
-  if (get_meas_result_command.len > 0) {
+  if (!get_meas_result_command.empty()) {
     command_to_write =
-        std::string(set_meas_type_command.data(), set_meas_type_command.len) +
-        ";" +
-        std::string(get_meas_result_command.data(),
-                    get_meas_result_command.len) +
-        '?';
+        set_meas_type_command + ";" + get_meas_result_command + '?';
   } else {
-    command_to_write =
-        std::string(set_meas_type_command.data(), set_meas_type_command.len) +
-        '?';
+    command_to_write = set_meas_type_command + '?';
   }
 
-  result = std::get<ViChar *>(scope.Query((ViChar *)command_to_write.c_str()));
+  // reply points into the session buffer, copied before other threads
+  // (spectrum worker, tuner, SRQ notifier) can query again
+  bool query_success;
+  std::string reply;
+  {
+    auto session = scope.LockSession();
+    auto [success, result] = scope.Query((ViChar *)command_to_write.c_str());
+    query_success = success;
+    reply = oscilloscope_utils::viCharArrToString(result);
+  }
 
   try {
-    result_to_display = oscilloscope_utils::convertMeasurementResult(
-        oscilloscope_utils::viCharArrToString(result));
+    result_to_display = oscilloscope_utils::convertMeasurementResult(reply);
   } catch (const std::exception &e) {
     spdlog::error("Exception converting scientific notation:\n{}", e.what());
     return;
@@ -124,34 +286,41 @@ void MainWindow::on_FrequencyPushbutton_clicked() {
       oscilloscope_utils::convertExponentToSI(std::get<1>(result_to_display)) +
       "Hz";
   ui->FrequencyResultLabel->setText(QString::fromStdString(exponent));
+
+  // failed query leaves the previous reply in the buffer
+  if (query_success) {
+    logMeasurement("f",
+                   std::get<0>(result_to_display) *
+                       std::pow(10, std::get<1>(result_to_display)));
+  }
 }
 
 void MainWindow::on_VrmsPushbutton_clicked() {
-  ViChar *result;
+  auto commands = commands_tree.GetCommandTable();
   std::tuple<double, int> result_to_display;
-  auto set_meas_type_command =
-      commands_tree.GetCommandTree()["measurements"]["voltage_rms"].val();
-  auto get_meas_result_command =
-      commands_tree.GetCommandTree()["measurements"]["get_result"].val();
+  auto set_meas_type_command = commands->Get("measurements.voltage_rms");
+  auto get_meas_result_command = commands->Get("measurements.get_result");
   std::string command_to_write;
-  if (get_meas_result_command.len > 0) {
+  if (!get_meas_result_command.empty()) {
     command_to_write =
-        std::string(set_meas_type_command.data(), set_meas_type_command.len) +
-        ";" +
-        std::string(get_meas_result_command.data(),
-                    get_meas_result_command.len) +
-        '?';
+        set_meas_type_command + ";" + get_meas_result_command + '?';
   } else {
-    command_to_write =
-        std::string(set_meas_type_command.data(), set_meas_type_command.len) +
-        '?';
+    command_to_write = set_meas_type_command + '?';
   }
 
-  result = std::get<ViChar *>(scope.Query((ViChar *)command_to_write.c_str()));
+  // reply points into the session buffer, copied before other threads
+  // (spectrum worker, tuner, SRQ notifier) can query again
+  bool query_success;
+  std::string reply;
+  {
+    auto session = scope.LockSession();
+    auto [success, result] = scope.Query((ViChar *)command_to_write.c_str());
+    query_success = success;
+    reply = oscilloscope_utils::viCharArrToString(result);
+  }
 
   try {
-    result_to_display = oscilloscope_utils::convertMeasurementResult(
-        oscilloscope_utils::viCharArrToString(result));
+    result_to_display = oscilloscope_utils::convertMeasurementResult(reply);
   } catch (const std::exception &e) {
     spdlog::error("Exception converting scientific notation:\n{}", e.what());
     return;
@@ -165,14 +334,21 @@ void MainWindow::on_VrmsPushbutton_clicked() {
       oscilloscope_utils::convertExponentToSI(std::get<1>(result_to_display)) +
       "V";
   ui->VrmsResultLabel->setText(QString::fromStdString(exponent));
+
+  // failed query leaves the previous reply in the buffer
+  if (query_success) {
+    logMeasurement("Vrms",
+                   std::get<0>(result_to_display) *
+                       std::pow(10, std::get<1>(result_to_display)));
+  }
 }
 
 void MainWindow::on_ChannelSpinbox_valueChanged() {
-  auto command =
-      commands_tree.GetCommandTree()["measurements"]["source_channel"].val();
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("measurements.source_channel");
   const int channel = ui->ChannelSpinbox->value();
 
-  std::string command_to_write = std::string(command.data(), command.len);
+  std::string command_to_write = command;
   std::string channel_to_write = std::to_string(channel);
 
   command_to_write = std::regex_replace(command_to_write,
@@ -183,19 +359,18 @@ void MainWindow::on_ChannelSpinbox_valueChanged() {
 }
 
 void MainWindow::on_AcqModePushbutton_clicked() {
-  // read commands from file
-  auto acq_count =
-      commands_tree.GetCommandTree()["acquisition"]["acq_count"].val();
-  auto command = commands_tree.GetCommandTree()["acquisition"]["mode"].val();
-  auto acq_mode = commands_tree
-                      .GetCommandTree()["acquisition"]["types"]
-                                       [ui->AcqModeComboBox->currentIndex()]
-                      .val();
+  // read commands from file, one table for all of them
+  auto commands = commands_tree.GetCommandTable();
+  auto acq_count = commands->Get("acquisition.acq_count");
+  auto command = commands->Get("acquisition.mode");
+  auto acq_mode = commands->Get(
+      "acquisition.types." +
+      std::to_string(ui->AcqModeComboBox->currentIndex()));
 
   // convert to std::string
-  std::string acq_count_to_write = std::string(acq_count.data(), acq_count.len);
-  std::string command_to_write = std::string(command.data(), command.len);
-  std::string acq_mode_to_write = std::string(acq_mode.data(), acq_mode.len);
+  std::string acq_count_to_write = acq_count;
+  std::string command_to_write = command;
+  std::string acq_mode_to_write = acq_mode;
 
   // replace placeholder with actual value
   command_to_write = std::regex_replace(command_to_write,
@@ -211,20 +386,34 @@ void MainWindow::on_AcqModePushbutton_clicked() {
   scope.Write((ViChar *)command_to_write.c_str());
 }
 
+void MainWindow::on_SingleAcqPushbutton_clicked() {
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("acquisition.single");
+  ui->SingleAcqPushbutton->setEnabled(false);
+  scope.WriteAndNotify(command.c_str(), [this](bool done) {
+    QMetaObject::invokeMethod(this, [this, done]() {
+      if (done) {
+        spdlog::info("Single acquisition completed!");
+      } else {
+        spdlog::error("Single acquisition not completed");
+      }
+      ui->SingleAcqPushbutton->setEnabled(true);
+    });
+  });
+}
+
 void MainWindow::on_ViClearPushButton_clicked() {
   scope.ViClear();
 }
 
 void MainWindow::on_ChannelVisibilityEnablePushButton_clicked() {
-  auto command =
-      commands_tree.GetCommandTree()["channels"]["display_state"].val();
-  auto state_disable =
-      commands_tree.GetCommandTree()["channels"]["states"]["on"].val();
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("channels.display_state");
+  auto state_disable = commands->Get("channels.states.on");
   const int channel = ui->ChannelSpinbox->value();
 
-  std::string command_to_write = std::string(command.data(), command.len);
-  std::string state_to_write =
-      std::string(state_disable.data(), state_disable.len);
+  std::string command_to_write = command;
+  std::string state_to_write = state_disable;
   std::string channel_to_write = std::to_string(channel);
 
   command_to_write = std::regex_replace(command_to_write,
@@ -238,15 +427,13 @@ void MainWindow::on_ChannelVisibilityEnablePushButton_clicked() {
 }
 
 void MainWindow::on_ChannelVisibilityDisablePushButton_clicked() {
-  auto command =
-      commands_tree.GetCommandTree()["channels"]["display_state"].val();
-  auto state_disable =
-      commands_tree.GetCommandTree()["channels"]["states"]["off"].val();
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("channels.display_state");
+  auto state_disable = commands->Get("channels.states.off");
   const int channel = ui->ChannelSpinbox->value();
 
-  std::string command_to_write = std::string(command.data(), command.len);
-  std::string state_to_write =
-      std::string(state_disable.data(), state_disable.len);
+  std::string command_to_write = command;
+  std::string state_to_write = state_disable;
   std::string channel_to_write = std::to_string(channel);
 
   command_to_write = std::regex_replace(command_to_write,
@@ -260,12 +447,12 @@ void MainWindow::on_ChannelVisibilityDisablePushButton_clicked() {
 }
 
 void MainWindow::on_VScaleDial_valueChanged(int value) {
-  auto command =
-      commands_tree.GetCommandTree()["channels"]["scale"]["vertical"].val();
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("channels.scale.vertical");
   const int channel = ui->ChannelSpinbox->value();
   std::string exponent = ui->VScaleComboBox->currentText().toStdString();
 
-  std::string command_to_write = std::string(command.data(), command.len);
+  std::string command_to_write = command;
   std::string channel_to_write = std::to_string(channel);
   std::string exponent_to_write =
       std::to_string(oscilloscope_utils::convertSIToExponent(exponent));
@@ -294,12 +481,12 @@ void MainWindow::on_VScaleDial_valueChanged(int value) {
 }
 
 void MainWindow::on_VOffsetDial_valueChanged(int value) {
-  auto command =
-      commands_tree.GetCommandTree()["channels"]["offset"]["vertical"].val();
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("channels.offset.vertical");
   const int channel = ui->ChannelSpinbox->value();
   std::string exponent = ui->VOffsetComboBox->currentText().toStdString();
 
-  std::string command_to_write = std::string(command.data(), command.len);
+  std::string command_to_write = command;
   std::string channel_to_write = std::to_string(channel);
   std::string exponent_to_write =
       std::to_string(oscilloscope_utils::convertSIToExponent(exponent));
@@ -330,12 +517,12 @@ void MainWindow::on_VOffsetDial_valueChanged(int value) {
 }
 
 void MainWindow::on_HScaleDial_valueChanged(int value) {
-  auto command =
-      commands_tree.GetCommandTree()["channels"]["scale"]["horizontal"].val();
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("channels.scale.horizontal");
   const int channel = ui->ChannelSpinbox->value();
   std::string exponent = ui->HScaleComboBox->currentText().toStdString();
 
-  std::string command_to_write = std::string(command.data(), command.len);
+  std::string command_to_write = command;
   std::string channel_to_write = std::to_string(channel);
   std::string exponent_to_write =
       std::to_string(oscilloscope_utils::convertSIToExponent(exponent));
@@ -364,12 +551,12 @@ void MainWindow::on_HScaleDial_valueChanged(int value) {
 }
 
 void MainWindow::on_HOffsetDial_valueChanged(int value) {
-  auto command =
-      commands_tree.GetCommandTree()["channels"]["offset"]["horizontal"].val();
+  auto commands = commands_tree.GetCommandTable();
+  auto command = commands->Get("channels.offset.horizontal");
   const int channel = ui->ChannelSpinbox->value();
   std::string exponent = ui->HOffsetComboBox->currentText().toStdString();
 
-  std::string command_to_write = std::string(command.data(), command.len);
+  std::string command_to_write = command;
   std::string channel_to_write = std::to_string(channel);
   std::string exponent_to_write =
       std::to_string(oscilloscope_utils::convertSIToExponent(exponent));
@@ -398,3 +585,572 @@ void MainWindow::on_HOffsetDial_valueChanged(int value) {
 
   ui->HOffsetLCD->display(value);
 }
+
+/**
+ * Reads one record of the channel with its preamble. Does not touch
+ * widgets, so it may run outside the GUI thread.
+ */
+bool MainWindow::acquireWaveform(int channel,
+                                 WaveformProcessing::RecordMetadata &metadata,
+                                 std::vector<uint8_t> &samples) {
+  auto commands = commands_tree.GetCommandTable();
+  if (!commands->HasSection("waveform")) {
+    spdlog::error("Dialect has no waveform section");
+    return false;
+  }
+  auto commandString = [&](const char *key) {
+    return commands->Get(std::string("waveform.") + key);
+  };
+  auto queryNumber = [&](const char *key) {
+    auto [success, reply] = scope.Query(commandString(key).c_str());
+    if (!success) {
+      throw std::runtime_error(std::string("preamble query failed: ") + key);
+    }
+    return oscilloscope_utils::convertReplyToDouble(
+        oscilloscope_utils::viCharArrToString(reply));
+  };
+
+  metadata.timestamp = std::chrono::system_clock::now();
+  metadata.channel = channel;
+  metadata.sample_width = scope.GetTransferProfile().sample_width;
+  metadata.signed_samples = commandString("signed_samples") == "true";
+
+  std::string source_command =
+      std::regex_replace(commandString("source"),
+                         std::regex("\\{channel_number\\}"),
+                         std::to_string(channel));
+  auto encoding = commandString(metadata.sample_width == 2 ? "encodings.word"
+                                                          : "encodings.byte");
+  // dialects of scopes with unreliable binary transfer ask for ASCII
+  const bool ascii = commands->Has("waveform.ascii_format") &&
+                     !commands->Get("waveform.ascii_format").empty();
+  std::string format_command =
+      std::regex_replace(commandString(ascii ? "ascii_format" : "format"),
+                         std::regex("\\{encoding\\}"),
+                         encoding);
+  // other threads must not change source between preamble and data
+  auto session = scope.LockSession();
+  scope.Write(source_command.c_str());
+  scope.Write(format_command.c_str());
+
+  try {
+    metadata.scaling.x_increment = queryNumber("x_increment");
+    metadata.scaling.y_increment = queryNumber("y_increment");
+    metadata.scaling.y_origin = queryNumber("y_origin");
+    metadata.scaling.y_reference = queryNumber("y_reference");
+  } catch (const std::exception &e) {
+    spdlog::error("Error reading waveform preamble:\n{}", e.what());
+    return false;
+  }
+
+  if (!scope.Write(commandString("data").c_str()) ||
+      !(ascii ? readAsciiCurve(metadata, samples)
+              : scope.ReadBlock(samples))) {
+    spdlog::error("Error reading waveform data");
+    scope.ViClear();
+    return false;
+  }
+  metadata.sample_count = samples.size() / metadata.sample_width;
+  return true;
+}
+
+/**
+ * Reads comma separated sample codes and stores them as big endian binary
+ * samples, so ASCII records are handled like binary ones. Called with
+ * session lock held, which also guards the reused buffers.
+ */
+bool MainWindow::readAsciiCurve(
+    const WaveformProcessing::RecordMetadata &metadata,
+    std::vector<uint8_t> &samples) {
+  if (!scope.ReadResponse(ascii_reply, scope.GetTransferProfile().chunk_size)) {
+    return false;
+  }
+
+  // every value takes at least one digit and a delimiter
+  std::string_view reply((const char *)ascii_reply.data(), ascii_reply.size());
+  ascii_codes.resize(reply.size() / 2 + 1);
+  size_t count = 0;
+  if (!ascii_parser.Parse(
+          reply, ascii_codes.data(), ascii_codes.size(), count)) {
+    return false;
+  }
+
+  samples.resize(count * metadata.sample_width);
+  for (size_t i = 0; i < count; i++) {
+    if (metadata.sample_width == 2) {
+      samples[2 * i] = (uint16_t)ascii_codes[i] >> 8;
+      samples[2 * i + 1] = (uint16_t)ascii_codes[i] & 0xFF;
+    } else {
+      samples[i] = (uint8_t)ascii_codes[i];
+    }
+  }
+  return true;
+}
+
+void MainWindow::showHistoryRecord(uint64_t id) {
+  WaveformProcessing::HistoryRecord record;
+  if (!history || !history->Get(id, record)) {
+    return;
+  }
+
+  std::vector<float> volts;
+  WaveformProcessing::decodeVolts(record.samples, record.metadata, volts);
+  ui->WaveformPlot->setData(std::move(volts),
+                            0.0,
+                            record.metadata.scaling.x_increment,
+                            "s",
+                            "V");
+
+  QDateTime time = QDateTime::fromMSecsSinceEpoch(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          record.metadata.timestamp.time_since_epoch())
+          .count());
+  ui->HistoryRecordLabel->setText(
+      QString("#%1 %2 CH%3 Vpp %4 f %5")
+          .arg(id)
+          .arg(time.toString("HH:mm:ss.zzz"))
+          .arg(record.metadata.channel)
+          .arg(QString::fromStdString(oscilloscope_utils::formatSI(
+              record.stats[WaveformProcessing::Stat::Vpp], "V")))
+          .arg(QString::fromStdString(oscilloscope_utils::formatSI(
+              record.stats[WaveformProcessing::Stat::Frequency], "Hz"))));
+}
+
+void MainWindow::showHistoryResults(const std::vector<uint64_t> &ids) {
+  ui->HistoryResultsList->clear();
+  for (uint64_t id : ids) {
+    WaveformProcessing::HistoryRecord record;
+    if (!history->Get(id, record)) {
+      continue;
+    }
+    auto *item = new QListWidgetItem(
+        QString("#%1 Vpp %2 f %3")
+            .arg(id)
+            .arg(QString::fromStdString(oscilloscope_utils::formatSI(
+                record.stats[WaveformProcessing::Stat::Vpp], "V")))
+            .arg(QString::fromStdString(oscilloscope_utils::formatSI(
+                record.stats[WaveformProcessing::Stat::Frequency], "Hz"))));
+    item->setData(Qt::UserRole, QVariant::fromValue<qulonglong>(id));
+    ui->HistoryResultsList->addItem(item);
+  }
+  spdlog::info("History search found {} records", ids.size());
+}
+
+void MainWindow::on_AcquirePushbutton_clicked() {
+  WaveformProcessing::RecordMetadata metadata;
+  std::vector<uint8_t> samples;
+  if (!acquireWaveform(ui->ChannelSpinbox->value(), metadata, samples) ||
+      !filterRecord(acquire_filters, metadata, samples)) {
+    return;
+  }
+  // scale and offset as set with channels.scale/offset controls
+  metadata.vertical_scale =
+      ui->VScaleDial->value() *
+      std::pow(10,
+               oscilloscope_utils::convertSIToExponent(
+                   ui->VScaleComboBox->currentText().toStdString()));
+  metadata.vertical_offset =
+      ui->VOffsetDial->value() *
+      std::pow(10,
+               oscilloscope_utils::convertSIToExponent(
+                   ui->VOffsetComboBox->currentText().toStdString()));
+
+  uint64_t id = history->Append(metadata, samples.data(), samples.size());
+  if (id == 0) {
+    return;
+  }
+  // jump to the newest record
+  ui->HistorySlider->setRange(0, history->Size() - 1);
+  ui->HistorySlider->setValue(history->Size() - 1);
+  showHistoryRecord(id);
+}
+
+void MainWindow::on_HistorySlider_valueChanged(int value) {
+  if (history && history->Size() > 0) {
+    showHistoryRecord(history->FirstId() + value);
+  }
+}
+
+void MainWindow::on_HistorySizeSpinBox_valueChanged(int value) {
+  // new size starts an empty history, arena is allocated once here
+  const size_t capacity_bytes = (size_t)value * 1024 * 1024;
+  history = std::make_unique<WaveformProcessing::AcquisitionHistory>(
+      capacity_bytes, capacity_bytes / HISTORY_MIN_RECORD_BYTES);
+  ui->HistorySlider->setRange(0, 0);
+  ui->HistoryResultsList->clear();
+  ui->WaveformPlot->clear();
+  spdlog::info("Acquisition history size set to {} MB", value);
+}
+
+void MainWindow::on_HistorySearchPushbutton_clicked() {
+  showHistoryResults(
+      history->FindInRange(WaveformProcessing::Stat::Vpp,
+                           ui->HistoryVppThresholdSpinBox->value()));
+}
+
+void MainWindow::on_HistoryOutliersPushbutton_clicked() {
+  showHistoryResults(
+      history->FindOutliers(WaveformProcessing::Stat::Frequency, 3.0f));
+}
+
+void MainWindow::on_HistoryResultsList_itemClicked(QListWidgetItem *item) {
+  uint64_t id = item->data(Qt::UserRole).toULongLong();
+  if (id < history->FirstId()) {
+    spdlog::warn("Record #{} already removed from history", id);
+    return;
+  }
+  ui->HistorySlider->setValue(id - history->FirstId());
+}
+
+/**
+ * Copies filter controls to settings used by filterRecord. Changed
+ * settings start new streams, samples filtered with old coefficients are
+ * not mixed with new ones.
+ */
+void MainWindow::updateFilterSettings() {
+  WaveformProcessing::FilterSettings settings;
+  settings.type = static_cast<WaveformProcessing::FilterType>(
+      ui->FilterTypeComboBox->currentIndex());
+  settings.low_cutoff = ui->FilterLowCutoffSpinBox->value() * 1e3;
+  settings.high_cutoff = ui->FilterHighCutoffSpinBox->value() * 1e3;
+  settings.taps = ui->FilterTapsSpinBox->value();
+  settings.decimation = ui->FilterDecimationSpinBox->value();
+
+  std::lock_guard<std::mutex> lock(filter_mutex);
+  filter_settings = settings;
+  filter_enabled = ui->FilterEnableCheckBox->isChecked();
+  filter_generation++;
+}
+
+/**
+ * Replaces acquired record with its filtered and decimated version when
+ * filtering is enabled. Called from the GUI and spectrum threads, each with
+ * its own streams. Only settings are copied under the lock, so the GUI
+ * thread does not wait for filtering of the other one.
+ */
+bool MainWindow::filterRecord(FilterStreams &streams,
+                              WaveformProcessing::RecordMetadata &metadata,
+                              std::vector<uint8_t> &samples) {
+  WaveformProcessing::FilterSettings settings;
+  bool enabled;
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(filter_mutex);
+    settings = filter_settings;
+    enabled = filter_enabled;
+    generation = filter_generation;
+  }
+  if (streams.generation != generation) {
+    streams.filters.clear();
+    streams.generation = generation;
+  }
+  if (!enabled) {
+    return true;
+  }
+  auto filter = streams.filters.try_emplace(metadata.channel, settings).first;
+  WaveformProcessing::RecordMetadata filtered_metadata;
+  std::vector<uint8_t> filtered;
+  if (!filter->second.ProcessRecord(
+          samples.data(), metadata, filtered_metadata, filtered)) {
+    streams.filters.erase(filter);
+    return false;
+  }
+  metadata = filtered_metadata;
+  samples = std::move(filtered);
+  return true;
+}
+
+void MainWindow::on_FilterEnableCheckBox_toggled(bool checked) {
+  updateFilterSettings();
+  spdlog::info("FIR filter {}", checked ? "enabled" : "disabled");
+}
+
+void MainWindow::on_FilterTypeComboBox_currentIndexChanged(int index) {
+  ui->FilterLowCutoffSpinBox->setEnabled(
+      static_cast<WaveformProcessing::FilterType>(index) ==
+      WaveformProcessing::FilterType::BandPass);
+  updateFilterSettings();
+}
+
+void MainWindow::on_FilterLowCutoffSpinBox_valueChanged(double value) {
+  updateFilterSettings();
+}
+
+void MainWindow::on_FilterHighCutoffSpinBox_valueChanged(double value) {
+  updateFilterSettings();
+}
+
+void MainWindow::on_FilterTapsSpinBox_valueChanged(int value) {
+  updateFilterSettings();
+}
+
+void MainWindow::on_FilterDecimationSpinBox_valueChanged(int value) {
+  updateFilterSettings();
+}
+
+/**
+ * Acquires selected channels and computes their spectra in a worker
+ * thread. In continuous mode next analysis starts when results of the
+ * previous one are shown, so refresh rate follows transfer and FFT time.
+ */
+void MainWindow::startSpectrumAnalysis() {
+  if (spectrum_running) {
+    return;
+  }
+
+  std::vector<int> channels;
+  const QCheckBox *channel_boxes[] = {ui->SpectrumCh1CheckBox,
+                                      ui->SpectrumCh2CheckBox,
+                                      ui->SpectrumCh3CheckBox,
+                                      ui->SpectrumCh4CheckBox};
+  for (int i = 0; i < 4; i++) {
+    if (channel_boxes[i]->isChecked()) {
+      channels.push_back(i + 1);
+    }
+  }
+  if (channels.empty()) {
+    spdlog::warn("No channel selected for spectrum analysis");
+    return;
+  }
+
+  WaveformProcessing::SpectrumSettings settings;
+  settings.window = static_cast<WaveformProcessing::WindowType>(
+      ui->SpectrumWindowComboBox->currentIndex());
+  settings.segment_length = ui->SpectrumSegmentSpinBox->value();
+  settings.overlap = ui->SpectrumOverlapSpinBox->value() / 100.0;
+  settings.harmonics = ui->SpectrumHarmonicsSpinBox->value();
+  spectrum_analyzer.SetSettings(settings);
+
+  if (spectrum_thread.joinable()) {
+    spectrum_thread.join();
+  }
+  spectrum_running = true;
+  ui->SpectrumPushbutton->setEnabled(false);
+  spectrum_thread = std::thread([this, channels]() {
+    std::vector<std::vector<uint8_t>> records(channels.size());
+    std::vector<WaveformProcessing::SpectrumInput> inputs;
+    for (size_t i = 0; i < channels.size(); i++) {
+      WaveformProcessing::SpectrumInput input;
+      if (acquireWaveform(channels[i], input.metadata, records[i]) &&
+          filterRecord(spectrum_filters, input.metadata, records[i])) {
+        input.samples = records[i].data();
+        inputs.push_back(input);
+      }
+    }
+
+    auto spectra =
+        std::make_shared<std::vector<WaveformProcessing::Spectrum>>();
+    try {
+      *spectra = spectrum_analyzer.Analyze(inputs);
+    } catch (const std::exception &e) {
+      // escaping the thread would terminate the application
+      spdlog::error("Spectrum analysis failed: {}", e.what());
+      spectra->clear();
+    }
+    QMetaObject::invokeMethod(this, [this, spectra]() {
+      spectrum_running = false;
+      ui->SpectrumPushbutton->setEnabled(true);
+      showSpectra(*spectra);
+      if (ui->SpectrumContinuousCheckBox->isChecked() && !spectra->empty()) {
+        startSpectrumAnalysis();
+      }
+    });
+  });
+}
+
+void MainWindow::showSpectra(
+    const std::vector<WaveformProcessing::Spectrum> &spectra) {
+  if (spectra.empty()) {
+    ui->SpectrumResultsLabel->setText("Brak wyników analizy widma");
+    return;
+  }
+
+  // dBV, floor keeps empty bins plottable
+  std::vector<std::vector<float>> traces;
+  QStringList results;
+  for (const auto &spectrum : spectra) {
+    std::vector<float> decibels(spectrum.power.size());
+    for (size_t k = 0; k < decibels.size(); k++) {
+      decibels[k] = 10.0f * std::log10(std::max(spectrum.power[k], 1e-20f));
+    }
+    traces.push_back(std::move(decibels));
+    results.append(
+        QString("CH%1: f %2, %3 rms, THD %4 %, SNR %5 dB, uśrednień %6")
+            .arg(spectrum.channel)
+            .arg(QString::fromStdString(oscilloscope_utils::formatSI(
+                spectrum.dominant_frequency, "Hz")))
+            .arg(QString::fromStdString(
+                oscilloscope_utils::formatSI(spectrum.dominant_rms, "V")))
+            .arg(spectrum.thd * 100.0, 0, 'f', 3)
+            .arg(spectrum.snr_db, 0, 'f', 1)
+            .arg(spectrum.averages));
+  }
+  ui->SpectrumPlot->setTraces(
+      std::move(traces), 0.0, spectra.front().bin_width, "Hz", "dBV");
+  ui->SpectrumResultsLabel->setText(results.join("\n"));
+}
+
+void MainWindow::on_SpectrumPushbutton_clicked() {
+  startSpectrumAnalysis();
+}
+
+void MainWindow::on_SpectrumContinuousCheckBox_toggled(bool checked) {
+  if (checked) {
+    startSpectrumAnalysis();
+  }
+}
+
+void MainWindow::on_ScreenMirrorCheckBox_toggled(bool checked) {
+  if (!checked) {
+    screen_mirror.stop();
+    ui->ScreenMirrorStatusLabel->setText("Podgląd wyłączony");
+    return;
+  }
+
+  auto commands = commands_tree.GetCommandTable();
+  ScreenMirrorSettings settings;
+  if (commands->HasSection("display")) {
+    auto commandString = [&](const char *key) {
+      return commands->Get(std::string("display.") + key);
+    };
+    settings.setup_command = commandString("screenshot_setup");
+    settings.grab_command = commandString("screenshot");
+    settings.block_reply = commandString("screenshot_block") != "false";
+  }
+  settings.link_share = ui->ScreenLinkShareSpinBox->value() / 100.0;
+
+  // frames are reported from the mirror thread
+  screen_mirror.start(settings, [this](double transfer_ms, int pause_ms) {
+    QMetaObject::invokeMethod(this, [this, transfer_ms, pause_ms]() {
+      ui->ScreenView->setFrame(screen_mirror.frame());
+      ui->ScreenMirrorStatusLabel->setText(
+          QString("Transfer %1 ms, przerwa %2 ms")
+              .arg(transfer_ms, 0, 'f', 0)
+              .arg(pause_ms));
+    });
+  });
+  if (!screen_mirror.isRunning()) {
+    ui->ScreenMirrorCheckBox->setChecked(false);
+  }
+}
+
+void MainWindow::on_ScreenLinkShareSpinBox_valueChanged(int value) {
+  screen_mirror.setLinkShare(value / 100.0);
+}
+
+void MainWindow::logMeasurement(const std::string &quantity, double value) {
+  // instrument reports 9.9E37 when there is nothing to measure
+  if (!(std::abs(value) < NOT_A_MEASUREMENT)) {
+    spdlog::debug("No {} measurement available, not logged", quantity);
+    return;
+  }
+  const std::string name =
+      "CH" + std::to_string(ui->ChannelSpinbox->value()) + " " + quantity;
+  const int64_t time_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  measurement_log.Append(name, time_ms, (float)value);
+
+  const QString series = QString::fromStdString(name);
+  if (ui->TrendSeriesComboBox->findText(series) < 0) {
+    ui->TrendSeriesComboBox->addItem(series);
+  }
+  if (ui->TrendSeriesComboBox->currentText() == series) {
+    showTrend();
+  }
+}
+
+// measurements go through the same path as when buttons are clicked
+void MainWindow::pollMeasurements() {
+  on_VrmsPushbutton_clicked();
+  on_FrequencyPushbutton_clicked();
+  // failed measurements append nothing, buffered ones are written by age
+  measurement_log.FlushExpired(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+void MainWindow::showTrend() {
+  const std::string name = ui->TrendSeriesComboBox->currentText().toStdString();
+  const MeasurementLog::TimeSeries *series = measurement_log.Find(name);
+  if (series == nullptr) {
+    ui->TrendPlot->clear();
+    return;
+  }
+
+  // spans of TrendSpanComboBox items
+  constexpr int64_t HOUR_MS = 3600 * 1000;
+  const int64_t spans_ms[] = {60 * 1000,
+                              600 * 1000,
+                              HOUR_MS,
+                              24 * HOUR_MS,
+                              7 * 24 * HOUR_MS,
+                              30 * 24 * HOUR_MS,
+                              365 * 24 * HOUR_MS};
+  const char *resolution_names[] = {"surowe", "1 s", "1 min", "1 h"};
+  const int64_t span_ms = spans_ms[std::clamp(
+      ui->TrendSpanComboBox->currentIndex(), 0, (int)std::size(spans_ms) - 1)];
+
+  // span ends at the newest sample, so series loaded from file are shown
+  MeasurementLog::Resolution resolution;
+  const int64_t from_ms = series->LastTime() - span_ms;
+  auto entries = series->Query(
+      from_ms, series->LastTime(), TREND_MAX_POINTS, resolution);
+  if (entries.empty()) {
+    ui->TrendPlot->clear();
+    return;
+  }
+
+  std::vector<std::vector<float>> traces(3);
+  float minimum = entries.front().min;
+  float maximum = entries.front().max;
+  for (const auto &entry : entries) {
+    traces[0].push_back(entry.Mean());
+    traces[1].push_back(entry.min);
+    traces[2].push_back(entry.max);
+    minimum = std::min(minimum, entry.min);
+    maximum = std::max(maximum, entry.max);
+  }
+  const std::string unit = name.substr(name.rfind(' ') + 1) == "f" ? "Hz" : "V";
+  // entries are evenly spaced apart from gaps when nothing was measured
+  const double x_start = (entries.front().start_ms - from_ms) / 1000.0;
+  const double x_step =
+      (entries.back().start_ms - entries.front().start_ms) / 1000.0 /
+      std::max<size_t>(entries.size() - 1, 1);
+  ui->TrendPlot->setTraces(std::move(traces),
+                           x_start,
+                           x_step,
+                           "s",
+                           QString::fromStdString(unit));
+  ui->TrendInfoLabel->setText(
+      QString("Rozdzielczość: %1, punktów: %2, min %3, max %4")
+          .arg(resolution_names[static_cast<size_t>(resolution)])
+          .arg(entries.size())
+          .arg(QString::fromStdString(
+              oscilloscope_utils::formatSI(minimum, unit)))
+          .arg(QString::fromStdString(
+              oscilloscope_utils::formatSI(maximum, unit))));
+}
+
+void MainWindow::on_TrendPollCheckBox_toggled(bool checked) {
+  if (checked) {
+    measurement_timer.start(ui->TrendIntervalSpinBox->value() * 1000);
+  } else {
+    measurement_timer.stop();
+    measurement_log.Flush();
+  }
+}
+
+void MainWindow::on_TrendIntervalSpinBox_valueChanged(int value) {
+  measurement_timer.setInterval(value * 1000);
+}
+
+void MainWindow::on_TrendSeriesComboBox_currentIndexChanged(int) {
+  showTrend();
+}
+
+void MainWindow::on_TrendSpanComboBox_currentIndexChanged(int) {
+  showTrend();
+}
@@ -1,13 +1,30 @@
 #pragma once
 
+#include "AcquisitionHistory.hpp"
+#include "AsciiCurveParser.hpp"
 #include "CommandParser.hpp"
+#include "FirFilter.hpp"
 #include "InstrumentControl.hpp"
+#include "MeasurementLog.hpp"
+#include "SpectrumAnalyzer.hpp"
+#include "TransferTuner.hpp"
 #include "oscilloscope_utils.h"
+#include "screenmirror.h"
 #include <QApplication>
+#include <QCheckBox>
+#include <QDateTime>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QListWidgetItem>
 #include <QMainWindow>
+#include <QSettings>
 #include <QTextEdit>
 #include <QTextStream>
+#include <QTimer>
+#include <atomic>
+#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <regex>
@@ -21,6 +38,16 @@ class MainWindow;
 }
 QT_END_NAMESPACE
 
+// smallest record expected in history, limits number of history slots
+constexpr size_t HISTORY_MIN_RECORD_BYTES = 1000;
+// points of trend chart, resolution is chosen to stay below it
+constexpr size_t TREND_MAX_POINTS = 2000;
+// SCPI "no measurement available" value
+constexpr double NOT_A_MEASUREMENT = 9.9e37;
+// dialect is reloaded once its file stops changing for this long
+constexpr int DIALECT_RELOAD_DELAY_MS = 200;
+constexpr const char *SETTINGS_FILENAME = "OscilloscopeGUI.ini";
+
 class MainWindow : public QMainWindow {
   Q_OBJECT
 
@@ -29,7 +56,36 @@ public:
   ~MainWindow();
 
   void setupLogging(QTextEdit *textEdit);
+  void selectDialect();
+  void loadDialect();
+  void reloadDialect();
   void scopeSetup(ViChar scope_string[]);
+  void setupTransferProfile();
+  bool acquireWaveform(int channel,
+                       WaveformProcessing::RecordMetadata &metadata,
+                       std::vector<uint8_t> &samples);
+  bool readAsciiCurve(const WaveformProcessing::RecordMetadata &metadata,
+                      std::vector<uint8_t> &samples);
+  void updateFilterSettings();
+  /**
+   * One stream per channel, records continue previous ones of the channel.
+   * Each consumer has its own streams, used only by its thread, so records
+   * acquired for display and for spectrum are not interleaved.
+   */
+  struct FilterStreams {
+    std::map<int, WaveformProcessing::FirFilter> filters;
+    uint64_t generation = 0; // of settings the filters were made with
+  };
+  bool filterRecord(FilterStreams &streams,
+                    WaveformProcessing::RecordMetadata &metadata,
+                    std::vector<uint8_t> &samples);
+  void showHistoryRecord(uint64_t id);
+  void showHistoryResults(const std::vector<uint64_t> &ids);
+  void startSpectrumAnalysis();
+  void showSpectra(const std::vector<WaveformProcessing::Spectrum> &spectra);
+  void logMeasurement(const std::string &quantity, double value);
+  void pollMeasurements();
+  void showTrend();
 
 private slots:
   void on_AutoscalePushbutton_clicked();
@@ -38,6 +94,8 @@ private slots:
 
   void on_ConnectPushButton_clicked();
 
+  void on_DialectPushButton_clicked();
+
   void on_FrequencyPushbutton_clicked();
 
   void on_VrmsPushbutton_clicked();
@@ -46,6 +104,8 @@ private slots:
 
   void on_AcqModePushbutton_clicked();
 
+  void on_SingleAcqPushbutton_clicked();
+
   void on_ViClearPushButton_clicked();
 
   void on_ChannelVisibilityEnablePushButton_clicked();
@@ -60,10 +120,71 @@ private slots:
 
   void on_HOffsetDial_valueChanged(int value);
 
+  void on_AcquirePushbutton_clicked();
+
+  void on_HistorySlider_valueChanged(int value);
+
+  void on_HistorySizeSpinBox_valueChanged(int value);
+
+  void on_HistorySearchPushbutton_clicked();
+
+  void on_HistoryOutliersPushbutton_clicked();
+
+  void on_HistoryResultsList_itemClicked(QListWidgetItem *item);
+
+  void on_FilterEnableCheckBox_toggled(bool checked);
+
+  void on_FilterTypeComboBox_currentIndexChanged(int index);
+
+  void on_FilterLowCutoffSpinBox_valueChanged(double value);
+
+  void on_FilterHighCutoffSpinBox_valueChanged(double value);
+
+  void on_FilterTapsSpinBox_valueChanged(int value);
+
+  void on_FilterDecimationSpinBox_valueChanged(int value);
+
+  void on_SpectrumPushbutton_clicked();
+
+  void on_SpectrumContinuousCheckBox_toggled(bool checked);
+
+  void on_ScreenMirrorCheckBox_toggled(bool checked);
+
+  void on_ScreenLinkShareSpinBox_valueChanged(int value);
+
+  void on_TrendPollCheckBox_toggled(bool checked);
+
+  void on_TrendIntervalSpinBox_valueChanged(int value);
+
+  void on_TrendSeriesComboBox_currentIndexChanged(int index);
+
+  void on_TrendSpanComboBox_currentIndexChanged(int index);
+
 private:
   Ui::MainWindow *ui;
   QString commands_filename;
   InstrumentControl::InstrumentControl scope;
   CommandParser::CommandParser commands_tree;
+  QFileSystemWatcher dialect_watcher;
+  QTimer dialect_reload_timer;
+  std::future<void> dialect_reload;
+  InstrumentControl::TransferProfileStore transfer_profiles;
+  std::future<void> transfer_tuning;
+  std::unique_ptr<WaveformProcessing::AcquisitionHistory> history;
+  WaveformProcessing::AsciiCurveParser ascii_parser;
+  std::vector<ViByte> ascii_reply;
+  std::vector<int16_t> ascii_codes;
+  FilterStreams acquire_filters;
+  FilterStreams spectrum_filters;
+  WaveformProcessing::FilterSettings filter_settings;
+  bool filter_enabled = false;
+  uint64_t filter_generation = 0;
+  std::mutex filter_mutex; // guards settings only
+  WaveformProcessing::SpectrumAnalyzer spectrum_analyzer;
+  std::thread spectrum_thread;
+  std::atomic<bool> spectrum_running{false};
+  ScreenMirror screen_mirror{scope};
+  MeasurementLog::MeasurementLog measurement_log;
+  QTimer measurement_timer;
 };
 // MAINWINDOW_H
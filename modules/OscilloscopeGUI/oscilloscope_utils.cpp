@@ -106,4 +106,24 @@ std::string viCharArrToString(const ViChar *ptr) {
   std::string str = ptr;
   return str;
 }
+
+// Converts numeric reply, with or without command header
+// (e.g. ":WFMPRE:XINCR 4.0E-7" or "+4.0E-7")
+double convertReplyToDouble(const std::string &reply) {
+  size_t begin = reply.find_last_of(' ', reply.find_last_not_of(" \r\n"));
+  begin = begin == std::string::npos ? 0 : begin + 1;
+  return std::stod(reply.substr(begin));
+}
+
+// Formats value with SI prefix, i.e. 0.0123, "V" -> "12.3 mV"
+std::string formatSI(double value, const std::string &unit) {
+  int exponent = 0;
+  if (value != 0.0 && std::isfinite(value)) {
+    exponent = (int)std::floor(std::log10(std::fabs(value)) / 3) * 3;
+    exponent = std::max(-15, std::min(15, exponent));
+  }
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.4g ", value / std::pow(10, exponent));
+  return text + convertExponentToSI(exponent) + unit;
+}
 } // namespace oscilloscope_utils
@@ -1,5 +1,7 @@
 #pragma once
 #include "InstrumentControl.hpp"
+#include <algorithm>
+#include <cstdio>
 #include <math.h>
 #include <regex>
 #include <set>
@@ -10,6 +12,8 @@ std::tuple<double, int> convertMeasurementResult(const std::string &input);
 std::string convertExponentToSI(const int exponent);
 int convertSIToExponent(std::string si);
 std::string viCharArrToString(const ViChar *);
+double convertReplyToDouble(const std::string &reply);
+std::string formatSI(double value, const std::string &unit);
 }; // namespace oscilloscope_utils
 
 // OSCILLOSCOPE_UTILS_H
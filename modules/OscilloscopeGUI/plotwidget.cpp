@@ -0,0 +1,134 @@
+#include "plotwidget.h"
+#include "oscilloscope_utils.h"
+#include <algorithm>
+#include <iterator>
+
+constexpr int GRID_DIVISIONS_X = 10;
+constexpr int GRID_DIVISIONS_Y = 8;
+
+// trace colours follow usual channel colours of scopes
+static const QColor TRACE_COLORS[] = {QColor(255, 200, 0),
+                                      QColor(0, 200, 255),
+                                      QColor(255, 60, 200),
+                                      QColor(60, 255, 60)};
+
+PlotWidget::PlotWidget(QWidget *parent) : QWidget(parent) {
+  setMinimumHeight(200);
+}
+
+void PlotWidget::setData(std::vector<float> values,
+                         double x_start,
+                         double x_step,
+                         const QString &x_unit,
+                         const QString &y_unit) {
+  std::vector<std::vector<float>> traces;
+  traces.push_back(std::move(values));
+  setTraces(std::move(traces), x_start, x_step, x_unit, y_unit);
+}
+
+void PlotWidget::setTraces(std::vector<std::vector<float>> traces,
+                           double x_start,
+                           double x_step,
+                           const QString &x_unit,
+                           const QString &y_unit) {
+  this->traces = std::move(traces);
+  this->x_start = x_start;
+  this->x_step = x_step;
+  this->x_unit = x_unit;
+  this->y_unit = y_unit;
+  update();
+}
+
+void PlotWidget::setDecibelScale(bool enabled) {
+  this->decibel_scale = enabled;
+  update();
+}
+
+void PlotWidget::clear() {
+  this->traces.clear();
+  update();
+}
+
+QString PlotWidget::formatY(double value) const {
+  if (this->decibel_scale) {
+    return QString("%1 %2").arg(value, 0, 'f', 1).arg(this->y_unit);
+  }
+  return QString::fromStdString(
+      oscilloscope_utils::formatSI(value, this->y_unit.toStdString()));
+}
+
+void PlotWidget::paintEvent(QPaintEvent *) {
+  QPainter painter(this);
+  painter.fillRect(rect(), Qt::black);
+
+  // graticule
+  painter.setPen(QPen(QColor(60, 60, 60), 1, Qt::DotLine));
+  for (int i = 1; i < GRID_DIVISIONS_X; i++) {
+    int x = width() * i / GRID_DIVISIONS_X;
+    painter.drawLine(x, 0, x, height());
+  }
+  for (int i = 1; i < GRID_DIVISIONS_Y; i++) {
+    int y = height() * i / GRID_DIVISIONS_Y;
+    painter.drawLine(0, y, width(), y);
+  }
+
+  // common vertical range of all traces
+  size_t count = 0;
+  float minimum = 0.0f;
+  float maximum = 0.0f;
+  for (const auto &values : this->traces) {
+    if (values.empty()) {
+      continue;
+    }
+    auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
+    minimum = count == 0 ? *min_it : std::min(minimum, *min_it);
+    maximum = count == 0 ? *max_it : std::max(maximum, *max_it);
+    count = std::max(count, values.size());
+  }
+  if (count == 0 || width() < 2) {
+    return;
+  }
+  if (maximum <= minimum) {
+    maximum = minimum + 1.0f;
+  }
+  auto toY = [&](float value) {
+    return (height() - 1) * (1.0 - (value - minimum) / (maximum - minimum));
+  };
+
+  // min/max of samples falling into each pixel column
+  const int columns = std::min<size_t>(width(), count);
+  for (size_t trace = 0; trace < this->traces.size(); trace++) {
+    const std::vector<float> &values = this->traces[trace];
+    if (values.empty()) {
+      continue;
+    }
+    painter.setPen(QPen(TRACE_COLORS[trace % std::size(TRACE_COLORS)], 1));
+    QPointF previous;
+    for (int column = 0; column < columns; column++) {
+      size_t begin = count * column / columns;
+      size_t end = std::max(begin + 1, count * (column + 1) / columns);
+      if (end > values.size()) {
+        break;
+      }
+      auto [low, high] =
+          std::minmax_element(values.begin() + begin, values.begin() + end);
+      double x = (double)(width() - 1) * column / std::max(1, columns - 1);
+      painter.drawLine(QPointF(x, toY(*low)), QPointF(x, toY(*high)));
+      QPointF current(x, toY(values[begin]));
+      if (column > 0) {
+        painter.drawLine(previous, current);
+      }
+      previous = current;
+    }
+  }
+
+  // range labels
+  const double x_end = this->x_start + this->x_step * (count - 1);
+  painter.setPen(Qt::white);
+  painter.drawText(4, 14, formatY(maximum));
+  painter.drawText(4, height() - 4, formatY(minimum));
+  painter.drawText(rect().adjusted(0, 0, -4, -4),
+                   Qt::AlignRight | Qt::AlignBottom,
+                   QString::fromStdString(oscilloscope_utils::formatSI(
+                       x_end, this->x_unit.toStdString())));
+}
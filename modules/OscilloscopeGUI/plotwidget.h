@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QPaintEvent>
+#include <QPainter>
+#include <QWidget>
+#include <vector>
+
+/**
+ * Simple scope-like line plot. Long traces are drawn as min/max per pixel
+ * column so painting cost does not depend on record length. Several traces
+ * sharing x axis are drawn in channel colours.
+ */
+class PlotWidget : public QWidget {
+  Q_OBJECT
+
+public:
+  explicit PlotWidget(QWidget *parent = nullptr);
+
+  void setData(std::vector<float> values,
+               double x_start,
+               double x_step,
+               const QString &x_unit,
+               const QString &y_unit);
+  void setTraces(std::vector<std::vector<float>> traces,
+                 double x_start,
+                 double x_step,
+                 const QString &x_unit,
+                 const QString &y_unit);
+  void setDecibelScale(bool enabled);
+  void clear();
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+
+private:
+  QString formatY(double value) const;
+
+  std::vector<std::vector<float>> traces;
+  double x_start = 0.0;
+  double x_step = 1.0;
+  QString x_unit;
+  QString y_unit;
+  bool decibel_scale = false; // y values already in dB, no SI prefixes
+};
+// PLOTWIDGET_H
@@ -0,0 +1,147 @@
+#include "screenmirror.h"
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+
+// pause doubles with every unchanged frame, up to 2^MAX_BACKOFF_STEPS
+constexpr int MAX_BACKOFF_STEPS = 5;
+
+ScreenMirror::ScreenMirror(InstrumentControl::InstrumentControl &scope)
+    : scope(scope) {}
+
+ScreenMirror::~ScreenMirror() {
+  stop();
+}
+
+void ScreenMirror::start(const ScreenMirrorSettings &settings,
+                         FrameCallback callback) {
+  if (this->running) {
+    return;
+  }
+  if (settings.grab_command.empty()) {
+    spdlog::error("Dialect has no screenshot command");
+    return;
+  }
+
+  this->settings = settings;
+  this->callback = std::move(callback);
+  setLinkShare(settings.link_share);
+  this->payload_hash = 0;
+  if (!settings.setup_command.empty()) {
+    this->scope.Write(settings.setup_command.c_str());
+  }
+
+  this->running = true;
+  this->worker = std::thread(&ScreenMirror::run, this);
+  spdlog::info("Screen mirror started");
+}
+
+void ScreenMirror::stop() {
+  {
+    std::lock_guard<std::mutex> lock(this->wake_mutex);
+    this->running = false;
+  }
+  this->wake.notify_all();
+  if (this->worker.joinable()) {
+    this->worker.join();
+    spdlog::info("Screen mirror stopped");
+  }
+}
+
+bool ScreenMirror::isRunning() const {
+  return this->running;
+}
+
+void ScreenMirror::setLinkShare(double share) {
+  this->link_share = std::clamp(share, 0.05, 0.9);
+}
+
+QImage ScreenMirror::frame() const {
+  std::lock_guard<std::mutex> lock(this->frame_mutex);
+  return this->front;
+}
+
+void ScreenMirror::run() {
+  int unchanged_frames = 0;
+  while (this->running) {
+    double transfer_ms = 0.0;
+    bool changed = false;
+    if (grab(transfer_ms)) {
+      const size_t hash = std::hash<std::string_view>()(std::string_view(
+          (const char *)this->payload.data(), this->payload.size()));
+      // same payload means same screen, nothing to decode or repaint
+      if (hash != this->payload_hash && decode()) {
+        this->payload_hash = hash;
+        changed = true;
+      }
+    }
+
+    // link is kept busy for at most link_share of the time
+    const double share = this->link_share;
+    unchanged_frames =
+        changed ? 0 : std::min(unchanged_frames + 1, MAX_BACKOFF_STEPS);
+    const int pause_ms = std::clamp(
+        (int)(transfer_ms * (1.0 - share) / share) << unchanged_frames,
+        this->settings.min_interval_ms,
+        this->settings.max_interval_ms);
+    if (changed && this->callback) {
+      this->callback(transfer_ms, pause_ms);
+    }
+
+    std::unique_lock<std::mutex> lock(this->wake_mutex);
+    this->wake.wait_for(lock, std::chrono::milliseconds(pause_ms), [this]() {
+      return !this->running;
+    });
+  }
+}
+
+/**
+ * Reads one screen image into payload. Session is locked only for the
+ * transfer, other commands can go between frames.
+ */
+bool ScreenMirror::grab(double &transfer_ms) {
+  auto session = this->scope.LockSession();
+  const ViUInt32 previous_timeout = this->scope.GetTimeout();
+  this->scope.SetTimeout(std::max(previous_timeout, SCREENSHOT_TIMEOUT_MS));
+
+  auto begin = std::chrono::steady_clock::now();
+  bool success = this->scope.Write(this->settings.grab_command.c_str());
+  if (success) {
+    success = this->settings.block_reply
+                  ? this->scope.ReadBlock(this->payload)
+                  : this->scope.ReadResponse(
+                        this->payload,
+                        this->scope.GetTransferProfile().chunk_size);
+  }
+  transfer_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count();
+
+  this->scope.SetTimeout(previous_timeout);
+  if (!success) {
+    spdlog::error("Error reading screen image");
+    this->scope.ViClear();
+  }
+  return success;
+}
+
+/**
+ * Decodes payload into back buffer, which keeps its pixel memory when the
+ * GUI no longer shares it, and makes it the front frame.
+ */
+bool ScreenMirror::decode() {
+  QByteArray data = QByteArray::fromRawData((const char *)this->payload.data(),
+                                            (int)this->payload.size());
+  QBuffer buffer(&data);
+  buffer.open(QIODevice::ReadOnly);
+  QImageReader reader(&buffer);
+  if (!reader.read(&this->back)) {
+    spdlog::error("Error decoding screen image: {}",
+                  reader.errorString().toStdString());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->frame_mutex);
+  this->front.swap(this->back);
+  return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "InstrumentControl.hpp"
+#include <QBuffer>
+#include <QImage>
+#include <QImageReader>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// screen images are much longer than replies the default timeout is set for
+constexpr ViUInt32 SCREENSHOT_TIMEOUT_MS = 5000;
+
+struct ScreenMirrorSettings {
+  std::string setup_command; // display.screenshot_setup
+  std::string grab_command;  // display.screenshot
+  bool block_reply = true;   // display.screenshot_block
+  double link_share = 0.25;  // fraction of link time spent on grabbing
+  int min_interval_ms = 100;
+  int max_interval_ms = 5000;
+};
+
+/**
+ * Periodically grabs the instrument screen in a worker thread. Image is
+ * decoded there into a reused back buffer and swapped with the front one
+ * read by GUI. Frames whose payload did not change are neither decoded
+ * nor reported.
+ *
+ * Grabs take session lock only for the transfer, the pause after it keeps
+ * link busy for at most link_share of the time, so control commands are
+ * not blocked. Pause grows while the screen is static.
+ */
+class ScreenMirror {
+public:
+  // called from the worker thread after a new frame is decoded
+  using FrameCallback = std::function<void(double transfer_ms, int pause_ms)>;
+
+  explicit ScreenMirror(InstrumentControl::InstrumentControl &scope);
+  ~ScreenMirror();
+
+  void start(const ScreenMirrorSettings &settings, FrameCallback callback);
+  void stop();
+  bool isRunning() const;
+  void setLinkShare(double share);
+  QImage frame() const;
+
+private:
+  void run();
+  bool grab(double &transfer_ms);
+  bool decode();
+
+  InstrumentControl::InstrumentControl &scope;
+  ScreenMirrorSettings settings;
+  FrameCallback callback;
+
+  std::thread worker;
+  std::atomic<bool> running{false};
+  std::atomic<double> link_share{0.25};
+  std::mutex wake_mutex;
+  std::condition_variable wake;
+
+  std::vector<ViByte> payload;
+  size_t payload_hash = 0;
+  QImage back;
+  QImage front;
+  mutable std::mutex frame_mutex;
+};
+// SCREENMIRROR_H
@@ -0,0 +1,30 @@
+#include "screenwidget.h"
+
+ScreenWidget::ScreenWidget(QWidget *parent) : QWidget(parent) {
+  setMinimumHeight(200);
+}
+
+void ScreenWidget::setFrame(const QImage &frame) {
+  this->frame = frame;
+  update();
+}
+
+void ScreenWidget::clear() {
+  this->frame = QImage();
+  update();
+}
+
+void ScreenWidget::paintEvent(QPaintEvent *) {
+  QPainter painter(this);
+  painter.fillRect(rect(), Qt::black);
+  if (this->frame.isNull()) {
+    return;
+  }
+
+  QSize size = this->frame.size().scaled(this->size(), Qt::KeepAspectRatio);
+  QRect target(QPoint((width() - size.width()) / 2,
+                      (height() - size.height()) / 2),
+               size);
+  painter.setRenderHint(QPainter::SmoothPixmapTransform);
+  painter.drawImage(target, this->frame);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QImage>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QWidget>
+
+/**
+ * Shows the mirrored instrument screen scaled to the widget, keeping its
+ * aspect ratio.
+ */
+class ScreenWidget : public QWidget {
+  Q_OBJECT
+
+public:
+  explicit ScreenWidget(QWidget *parent = nullptr);
+
+  void setFrame(const QImage &frame);
+  void clear();
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+
+private:
+  QImage frame;
+};
+// SCREENWIDGET_H
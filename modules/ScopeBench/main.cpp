@@ -0,0 +1,128 @@
+#include "scope_bench.h"
+
+static void printUsage(const char *program) {
+  fmt::print(
+      "Usage: {} <resource string> <dialect.yml> [options]\n"
+      "Options:\n"
+      "  --workloads LIST    comma separated: "
+      "idn,write,measure,single,waveform\n"
+      "  --iterations N      operations per workload (default 100)\n"
+      "  --channel N         channel used by write/measure/waveform\n"
+      "  --timeout-ms N      VI_ATTR_TMO_VALUE for the session\n"
+      "  --buffer-size N     viSetBuf I/O buffer size in bytes\n"
+      "  --chunk-sizes LIST  comma separated waveform read chunk sizes\n"
+      "  --auto-tune         tune transfer parameters before workloads\n"
+      "  --precision-bits N  precision floor used by --auto-tune (8-16)\n"
+      "  --verbose           keep InstrumentControl logging enabled\n",
+      program);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  scope_bench::BenchOptions options;
+  options.resource_string = argv[1];
+  options.dialect_filename = argv[2];
+  bool verbose = false;
+
+  try {
+    for (int i = 3; i < argc; i++) {
+      std::string option = argv[i];
+      if (option == "--verbose") {
+        verbose = true;
+        continue;
+      }
+      if (option == "--auto-tune") {
+        options.auto_tune = true;
+        continue;
+      }
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("missing value for " + option);
+      }
+      std::string value = argv[++i];
+      if (option == "--workloads") {
+        options.workloads = scope_bench::splitList(value);
+      } else if (option == "--iterations") {
+        options.iterations = std::stoul(value);
+      } else if (option == "--channel") {
+        options.channel = std::stoi(value);
+      } else if (option == "--timeout-ms") {
+        options.timeout_ms = std::stoul(value);
+      } else if (option == "--buffer-size") {
+        options.buffer_size = std::stoul(value);
+      } else if (option == "--precision-bits") {
+        options.precision_floor_bits = std::stoi(value);
+      } else if (option == "--chunk-sizes") {
+        options.chunk_sizes.clear();
+        for (const std::string &chunk : scope_bench::splitList(value)) {
+          options.chunk_sizes.push_back(std::stoul(chunk));
+        }
+      } else {
+        throw std::invalid_argument("unknown option " + option);
+      }
+    }
+  } catch (const std::exception &e) {
+    fmt::print(stderr, "Invalid arguments: {}\n", e.what());
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // per-command logging would dominate the measured latency
+  spdlog::set_level(verbose ? spdlog::level::debug : spdlog::level::warn);
+
+  CommandParser::CommandParser commands_tree;
+  commands_tree.ReadYaml(options.dialect_filename.c_str());
+  const ryml::Tree commands = commands_tree.GetCommandTree();
+
+  InstrumentControl::InstrumentControl scope;
+  if (!scope.Connect(options.resource_string.data())) {
+    return 1;
+  }
+  if (options.timeout_ms > 0 && !scope.SetTimeout(options.timeout_ms)) {
+    return 1;
+  }
+  if (options.buffer_size > 0 && !scope.SetBufferSize(options.buffer_size)) {
+    return 1;
+  }
+
+  fmt::print("Instrument: {}\n", scope.GetIDString());
+  if (options.auto_tune) {
+    scope_bench::runAutoTune(scope, commands, options);
+  }
+  fmt::print("Timeout: {} ms, iterations: {}\n\n",
+             scope.GetTimeout(),
+             options.iterations);
+  scope_bench::printHeader();
+
+  for (const std::string &workload : options.workloads) {
+    std::vector<scope_bench::BenchResult> results;
+    if (workload == "idn") {
+      results.push_back(scope_bench::runIdnPingPong(scope, options));
+    } else if (workload == "write") {
+      results.push_back(scope_bench::runWriteStorm(scope, commands, options));
+    } else if (workload == "measure") {
+      results.push_back(
+          scope_bench::runMeasurementPolling(scope, commands, options));
+    } else if (workload == "single") {
+      results.push_back(
+          scope_bench::runSingleAcquisition(scope, commands, options));
+    } else if (workload == "waveform") {
+      for (ViUInt32 chunk_size : options.chunk_sizes) {
+        results.push_back(scope_bench::runWaveformRead(
+            scope, commands, options, chunk_size));
+      }
+    } else {
+      spdlog::error("Unknown workload {}", workload);
+      continue;
+    }
+
+    for (scope_bench::BenchResult &result : results) {
+      scope_bench::printResult(result);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,286 @@
+#include "scope_bench.h"
+#include <algorithm>
+#include <regex>
+#include <sstream>
+
+namespace scope_bench {
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMicroseconds(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+std::string nodeToString(ryml::ConstNodeRef node) {
+  auto value = node.val();
+  return std::string(value.data(), value.len);
+}
+
+std::vector<std::string> splitList(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+double percentile(const std::vector<double> &sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+BenchResult runIdnPingPong(InstrumentControl::InstrumentControl &scope,
+                           const BenchOptions &options) {
+  BenchResult result;
+  result.name = "idn";
+  result.latencies_us.reserve(options.iterations);
+
+  auto bench_start = Clock::now();
+  for (size_t i = 0; i < options.iterations; i++) {
+    auto start = Clock::now();
+    auto [success, reply] = scope.Query("*IDN?");
+    result.latencies_us.push_back(elapsedMicroseconds(start));
+    if (success) {
+      result.bytes += std::strlen(reply) + std::strlen("*IDN?");
+    } else {
+      result.failures++;
+    }
+    result.operations++;
+  }
+  result.elapsed_s = elapsedMicroseconds(bench_start) / 1e6;
+
+  return result;
+}
+
+BenchResult runWriteStorm(InstrumentControl::InstrumentControl &scope,
+                          const ryml::Tree &commands,
+                          const BenchOptions &options) {
+  BenchResult result;
+  result.name = "write";
+  result.latencies_us.reserve(options.iterations);
+
+  // toggle vertical scale between two values so every write changes state
+  std::string command = std::regex_replace(
+      nodeToString(commands["channels"]["scale"]["vertical"]),
+      std::regex("\\{channel_number\\}"),
+      std::to_string(options.channel));
+  const std::string commands_to_write[] = {
+      std::regex_replace(command, std::regex("\\{scale_value\\}"), "1E0"),
+      std::regex_replace(command, std::regex("\\{scale_value\\}"), "5E-1")};
+
+  auto bench_start = Clock::now();
+  for (size_t i = 0; i < options.iterations; i++) {
+    const std::string &command_to_write = commands_to_write[i % 2];
+    auto start = Clock::now();
+    if (scope.Write(command_to_write.c_str())) {
+      result.bytes += command_to_write.size();
+    } else {
+      result.failures++;
+    }
+    result.latencies_us.push_back(elapsedMicroseconds(start));
+    result.operations++;
+  }
+  // writes are only done when the instrument has processed all of them
+  scope.Query("*OPC?");
+  result.elapsed_s = elapsedMicroseconds(bench_start) / 1e6;
+
+  return result;
+}
+
+BenchResult runMeasurementPolling(InstrumentControl::InstrumentControl &scope,
+                                  const ryml::Tree &commands,
+                                  const BenchOptions &options) {
+  BenchResult result;
+  result.name = "measure";
+  result.latencies_us.reserve(options.iterations);
+
+  std::string source_command = std::regex_replace(
+      nodeToString(commands["measurements"]["source_channel"]),
+      std::regex("\\{channel_number\\}"),
+      std::to_string(options.channel));
+  scope.Write(source_command.c_str());
+
+  // same query layout as the GUI measurement buttons
+  std::string set_meas_type_command =
+      nodeToString(commands["measurements"]["frequency"]);
+  std::string get_meas_result_command =
+      nodeToString(commands["measurements"]["get_result"]);
+  std::string command_to_write;
+  if (!get_meas_result_command.empty()) {
+    command_to_write =
+        set_meas_type_command + ";" + get_meas_result_command + '?';
+  } else {
+    command_to_write = set_meas_type_command + '?';
+  }
+
+  auto bench_start = Clock::now();
+  for (size_t i = 0; i < options.iterations; i++) {
+    auto start = Clock::now();
+    auto [success, reply] = scope.Query(command_to_write.c_str());
+    result.latencies_us.push_back(elapsedMicroseconds(start));
+    if (success) {
+      result.bytes += std::strlen(reply) + command_to_write.size();
+    } else {
+      result.failures++;
+    }
+    result.operations++;
+  }
+  result.elapsed_s = elapsedMicroseconds(bench_start) / 1e6;
+
+  return result;
+}
+
+BenchResult runSingleAcquisition(InstrumentControl::InstrumentControl &scope,
+                                 const ryml::Tree &commands,
+                                 const BenchOptions &options) {
+  BenchResult result;
+  result.name = "single";
+  result.latencies_us.reserve(options.iterations);
+
+  // latency from request to instrument reported operation complete (SRQ)
+  std::string command = nodeToString(commands["acquisition"]["single"]);
+
+  auto bench_start = Clock::now();
+  for (size_t i = 0; i < options.iterations; i++) {
+    auto start = Clock::now();
+    if (!scope.WriteAndWait(command.c_str())) {
+      result.failures++;
+    }
+    result.latencies_us.push_back(elapsedMicroseconds(start));
+    result.operations++;
+  }
+  result.elapsed_s = elapsedMicroseconds(bench_start) / 1e6;
+
+  return result;
+}
+
+BenchResult runWaveformRead(InstrumentControl::InstrumentControl &scope,
+                            const ryml::Tree &commands,
+                            const BenchOptions &options,
+                            ViUInt32 chunk_size) {
+  BenchResult result;
+  result.name = "waveform/" + std::to_string(chunk_size);
+
+  if (!commands.rootref().has_child("waveform")) {
+    spdlog::error("Dialect file has no waveform section, skipping {}",
+                  result.name);
+    return result;
+  }
+
+  std::string source_command =
+      std::regex_replace(nodeToString(commands["waveform"]["source"]),
+                         std::regex("\\{channel_number\\}"),
+                         std::to_string(options.channel));
+  std::string format_command = std::regex_replace(
+      nodeToString(commands["waveform"]["format"]),
+      std::regex("\\{encoding\\}"),
+      nodeToString(commands["waveform"]["encodings"]["byte"]));
+  std::string data_command = nodeToString(commands["waveform"]["data"]);
+
+  scope.Write(source_command.c_str());
+  scope.Write(format_command.c_str());
+
+  std::vector<ViByte> block;
+  result.latencies_us.reserve(options.iterations);
+
+  auto bench_start = Clock::now();
+  for (size_t i = 0; i < options.iterations; i++) {
+    auto start = Clock::now();
+    bool success = scope.Write(data_command.c_str()) &&
+                   scope.ReadBlock(block, chunk_size);
+    result.latencies_us.push_back(elapsedMicroseconds(start));
+    if (success) {
+      result.bytes += block.size();
+    } else {
+      result.failures++;
+      scope.ViClear();
+    }
+    result.operations++;
+  }
+  result.elapsed_s = elapsedMicroseconds(bench_start) / 1e6;
+
+  return result;
+}
+
+InstrumentControl::TransferProfile
+runAutoTune(InstrumentControl::InstrumentControl &scope,
+            const ryml::Tree &commands,
+            const BenchOptions &options) {
+  if (!commands.rootref().has_child("waveform")) {
+    spdlog::error("Dialect file has no waveform section, cannot tune");
+    return {};
+  }
+
+  std::string format_command = nodeToString(commands["waveform"]["format"]);
+  InstrumentControl::TuningRequest request;
+  request.data_query = nodeToString(commands["waveform"]["data"]);
+  request.format_byte_command = std::regex_replace(
+      format_command,
+      std::regex("\\{encoding\\}"),
+      nodeToString(commands["waveform"]["encodings"]["byte"]));
+  request.format_word_command = std::regex_replace(
+      format_command,
+      std::regex("\\{encoding\\}"),
+      nodeToString(commands["waveform"]["encodings"]["word"]));
+  request.precision_floor_bits = options.precision_floor_bits;
+
+  scope.Write(std::regex_replace(nodeToString(commands["waveform"]["source"]),
+                                 std::regex("\\{channel_number\\}"),
+                                 std::to_string(options.channel))
+                  .c_str());
+
+  InstrumentControl::TransferProfile profile =
+      InstrumentControl::TransferTuner(scope).Tune(request);
+  if (profile.throughput_mb_s > 0.0) {
+    scope.ApplyTransferProfile(profile);
+    fmt::print("Tuned profile: chunk {} B, buffer {} B, timeout {} ms + "
+               "{:.1f} ms/MB, sample width {} B, {:.3f} MB/s\n\n",
+               profile.chunk_size,
+               profile.buffer_size,
+               profile.base_timeout_ms,
+               profile.timeout_ms_per_mb,
+               profile.sample_width,
+               profile.throughput_mb_s);
+  }
+  return profile;
+}
+
+void printHeader() {
+  fmt::print("{:<18} {:>8} {:>6} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+             "workload",
+             "ops",
+             "fail",
+             "ops/s",
+             "MB/s",
+             "p50 [ms]",
+             "p90 [ms]",
+             "p99 [ms]",
+             "max [ms]");
+}
+
+void printResult(BenchResult &result) {
+  std::sort(result.latencies_us.begin(), result.latencies_us.end());
+  const double elapsed_s = result.elapsed_s > 0.0 ? result.elapsed_s : 1e-9;
+  const double max_us =
+      result.latencies_us.empty() ? 0.0 : result.latencies_us.back();
+
+  fmt::print("{:<18} {:>8} {:>6} {:>10.1f} {:>10.3f} {:>10.3f} {:>10.3f} "
+             "{:>10.3f} {:>10.3f}\n",
+             result.name,
+             result.operations,
+             result.failures,
+             result.operations / elapsed_s,
+             result.bytes / elapsed_s / 1e6,
+             percentile(result.latencies_us, 0.50) / 1e3,
+             percentile(result.latencies_us, 0.90) / 1e3,
+             percentile(result.latencies_us, 0.99) / 1e3,
+             max_us / 1e3);
+}
+} // namespace scope_bench
@@ -0,0 +1,68 @@
+/*********************************************************************
+ * \file   scope_bench.h
+ * \brief  Scripted link workloads for the headless ScopeBench tool
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "CommandParser.hpp"
+#include "InstrumentControl.hpp"
+#include "TransferTuner.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace scope_bench {
+struct BenchOptions {
+  std::string resource_string;
+  std::string dialect_filename;
+  std::vector<std::string> workloads = {"idn", "write", "measure", "waveform"};
+  size_t iterations = 100;
+  int channel = 1;
+  ViUInt32 timeout_ms = 0;  // 0 - keep InstrumentControl default
+  ViUInt32 buffer_size = 0; // 0 - keep VISA default
+  std::vector<ViUInt32> chunk_sizes = {4096, 65536, 1048576};
+  bool auto_tune = false;
+  int precision_floor_bits = 8;
+};
+
+struct BenchResult {
+  std::string name;
+  size_t operations = 0;
+  size_t failures = 0;
+  size_t bytes = 0;
+  double elapsed_s = 0.0;
+  std::vector<double> latencies_us;
+};
+
+std::string nodeToString(ryml::ConstNodeRef node);
+std::vector<std::string> splitList(const std::string &list);
+double percentile(const std::vector<double> &sorted, double fraction);
+
+BenchResult runIdnPingPong(InstrumentControl::InstrumentControl &scope,
+                           const BenchOptions &options);
+BenchResult runWriteStorm(InstrumentControl::InstrumentControl &scope,
+                          const ryml::Tree &commands,
+                          const BenchOptions &options);
+BenchResult runMeasurementPolling(InstrumentControl::InstrumentControl &scope,
+                                  const ryml::Tree &commands,
+                                  const BenchOptions &options);
+BenchResult runSingleAcquisition(InstrumentControl::InstrumentControl &scope,
+                                 const ryml::Tree &commands,
+                                 const BenchOptions &options);
+BenchResult runWaveformRead(InstrumentControl::InstrumentControl &scope,
+                            const ryml::Tree &commands,
+                            const BenchOptions &options,
+                            ViUInt32 chunk_size);
+
+InstrumentControl::TransferProfile
+runAutoTune(InstrumentControl::InstrumentControl &scope,
+            const ryml::Tree &commands,
+            const BenchOptions &options);
+
+void printHeader();
+void printResult(BenchResult &result);
+}; // namespace scope_bench
+
+// SCOPE_BENCH_H
@@ -0,0 +1,122 @@
+#include "scope_transport.h"
+#include <cmath>
+
+static void printUsage(const char *program) {
+  fmt::print(
+      "Usage: {} <resource string> <dialect.yml> <sequence.yml> [options]\n"
+      "Options:\n"
+      "  --set NAME=VALUE    placeholder value, overrides sequence defaults\n"
+      "  --timeout-ms N      VI_ATTR_TMO_VALUE for the session\n"
+      "  --verbose           keep InstrumentControl logging enabled\n",
+      program);
+}
+
+static std::string
+formatLimits(const scope_sequence::MeasurementResult &result) {
+  if (std::isinf(result.min) && std::isinf(result.max)) {
+    return "-";
+  }
+  return fmt::format("[{:g}, {:g}]", result.min, result.max);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  const std::string resource_string = argv[1];
+  const std::string dialect_filename = argv[2];
+  const std::string sequence_filename = argv[3];
+  scope_sequence::Parameters overrides;
+  ViUInt32 timeout_ms = 0;
+  bool verbose = false;
+
+  try {
+    for (int i = 4; i < argc; i++) {
+      std::string option = argv[i];
+      if (option == "--verbose") {
+        verbose = true;
+        continue;
+      }
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("missing value for " + option);
+      }
+      std::string value = argv[++i];
+      if (option == "--set") {
+        const size_t separator = value.find('=');
+        if (separator == std::string::npos) {
+          throw std::invalid_argument("expected NAME=VALUE, got " + value);
+        }
+        overrides[value.substr(0, separator)] = value.substr(separator + 1);
+      } else if (option == "--timeout-ms") {
+        timeout_ms = std::stoul(value);
+      } else {
+        throw std::invalid_argument("unknown option " + option);
+      }
+    }
+  } catch (const std::exception &e) {
+    fmt::print(stderr, "Invalid arguments: {}\n", e.what());
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  spdlog::set_level(verbose ? spdlog::level::debug : spdlog::level::warn);
+
+  // whole sequence is resolved before connecting, errors show up early
+  CommandParser::CommandParser commands_tree;
+  if (!commands_tree.Load(dialect_filename)) {
+    return 1;
+  }
+  scope_sequence::Sequence sequence;
+  if (!scope_sequence::loadSequence(sequence_filename,
+                                    *commands_tree.GetCommandTable(),
+                                    overrides,
+                                    sequence)) {
+    return 1;
+  }
+
+  InstrumentControl::InstrumentControl scope;
+  if (!scope.Connect(const_cast<char *>(resource_string.c_str()))) {
+    return 1;
+  }
+  if (timeout_ms > 0 && !scope.SetTimeout(timeout_ms)) {
+    return 1;
+  }
+
+  fmt::print("Instrument: {}\n", scope.GetIDString());
+  fmt::print(
+      "Sequence: {}, {} steps\n\n", sequence.name, sequence.steps.size());
+  fmt::print("{:<20} {:<20} {:>14} {:>24} {}\n",
+             "step",
+             "measurement",
+             "value",
+             "limits",
+             "result");
+
+  // results are printed as soon as they are processed
+  scope_sequence::ScopeTransport transport(scope);
+  scope_sequence::SequenceRunner runner(transport);
+  scope_sequence::RunReport report = runner.Run(
+      sequence, [&](const scope_sequence::MeasurementResult &result) {
+        fmt::print("{:<20} {:<20} {:>14} {:>24} {}\n",
+                   result.step,
+                   result.name,
+                   result.valid ? fmt::format("{:g}", result.value)
+                                : result.reply,
+                   formatLimits(result),
+                   result.passed ? "PASS" : "FAIL");
+      });
+
+  fmt::print("\n{} commands in {} messages, {} *OPC? barriers, {:.1f} ms\n",
+             report.commands,
+             report.messages,
+             report.barriers,
+             report.elapsed_ms);
+  if (!report.completed) {
+    fmt::print("Sequence not completed\n");
+    return 1;
+  }
+  fmt::print("{}\n", report.Passed() ? "PASS" : "FAIL");
+  return report.Passed() ? 0 : 2;
+}
@@ -0,0 +1,45 @@
+/*********************************************************************
+ * \file   scope_transport.cpp
+ * \brief  Definition of ScopeTransport class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "scope_transport.h"
+#include <algorithm>
+
+namespace scope_sequence {
+ScopeTransport::ScopeTransport(InstrumentControl::InstrumentControl &scope)
+    : scope(scope) {}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+bool ScopeTransport::Write(const std::string &message) {
+  return this->scope.Write(message.c_str());
+}
+
+bool ScopeTransport::Query(const std::string &message,
+                           bool barrier,
+                           std::string &reply) {
+  // timeout change and reply buffer must not be seen by other threads
+  auto session = this->scope.LockSession();
+  // *OPC? returns only after overlapped commands like single acquisition
+  // complete
+  const ViUInt32 timeout = this->scope.GetTimeout();
+  if (barrier) {
+    this->scope.SetTimeout(std::max(timeout, SRQ_TIMEOUT_MS));
+  }
+  auto [success, result] = this->scope.Query(message.c_str());
+  if (success) {
+    reply = result;
+  }
+  if (barrier) {
+    this->scope.SetTimeout(timeout);
+  }
+  return success;
+}
+/*
+ * PUBLIC METHODS END
+ */
+} // namespace scope_sequence
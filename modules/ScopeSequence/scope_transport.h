@@ -0,0 +1,24 @@
+/*********************************************************************
+ * \file   scope_transport.h
+ * \brief  Sequence messages sent over an instrument session
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "InstrumentControl.hpp"
+#include "sequence_runner.h"
+
+namespace scope_sequence {
+class ScopeTransport : public SequenceTransport {
+public:
+  explicit ScopeTransport(InstrumentControl::InstrumentControl &scope);
+
+  bool Write(const std::string &message) override;
+  bool
+  Query(const std::string &message, bool barrier, std::string &reply) override;
+
+private:
+  InstrumentControl::InstrumentControl &scope;
+};
+} // namespace scope_sequence
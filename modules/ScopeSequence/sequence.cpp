@@ -0,0 +1,252 @@
+/*********************************************************************
+ * \file   sequence.cpp
+ * \brief  Loading of test sequence files
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "sequence.h"
+#include <algorithm>
+#include <fstream>
+#include <regex>
+#include <set>
+#include <spdlog/spdlog.h>
+
+namespace scope_sequence {
+// keys of a write or measure entry which are not its parameters
+static const std::set<std::string> ENTRY_KEYS = {
+    "command", "scpi", "name", "min", "max"};
+
+static std::string nodeToString(ryml::ConstNodeRef node) {
+  auto value = node.val();
+  return std::string(value.data(), value.len);
+}
+
+static std::string keyToString(ryml::ConstNodeRef node) {
+  auto key = node.key();
+  return std::string(key.data(), key.len);
+}
+
+static bool hasChild(ryml::ConstNodeRef node, const std::string &key) {
+  return node.is_map() && node.has_child(ryml::to_csubstr(key));
+}
+
+static void readParameters(ryml::ConstNodeRef node, Parameters &parameters) {
+  for (ryml::ConstNodeRef child : node.children()) {
+    if (ENTRY_KEYS.count(keyToString(child)) == 0) {
+      parameters[keyToString(child)] = nodeToString(child);
+    }
+  }
+}
+
+/**
+ * Returns command of a write or measure entry with placeholders filled,
+ * empty string on error. Entry is either a map with command (dialect
+ * path) or scpi key, or plain SCPI string.
+ */
+static std::string resolveCommand(ryml::ConstNodeRef entry,
+                                  const CommandParser::CommandTable &commands,
+                                  Parameters parameters,
+                                  bool &from_dialect) {
+  std::string command;
+  from_dialect = false;
+  if (!entry.is_map()) {
+    command = nodeToString(entry);
+  } else if (hasChild(entry, "command")) {
+    const std::string path = nodeToString(entry["command"]);
+    if (!commands.Has(path)) {
+      spdlog::error("Command {} not found in dialect", path);
+      return "";
+    }
+    command = commands.Get(path);
+    from_dialect = true;
+  } else if (hasChild(entry, "scpi")) {
+    command = nodeToString(entry["scpi"]);
+  }
+  if (command.empty()) {
+    spdlog::error("Sequence entry has no command");
+    return "";
+  }
+  if (entry.is_map()) {
+    readParameters(entry, parameters);
+  }
+
+  command = fillPlaceholders(command, parameters);
+  std::smatch placeholder;
+  if (std::regex_search(command, placeholder, std::regex("\\{\\w+\\}"))) {
+    spdlog::error("Placeholder {} of {} not set", placeholder.str(), command);
+    return "";
+  }
+  // commands are joined with ';', relative headers would change meaning
+  if (command[0] != ':' && command[0] != '*') {
+    spdlog::warn("Command {} does not start with ':' or '*'", command);
+  }
+  return command;
+}
+
+/**
+ * Makes query of the last command of a compound message by adding '?' to
+ * its header, parameters stay after it, e.g. ":MEASure:VRMS? CHANnel1".
+ * Commands already being queries are returned unchanged.
+ */
+static std::string toQuery(std::string command) {
+  const size_t separator = command.rfind(';');
+  const size_t start = separator == std::string::npos ? 0 : separator + 1;
+  size_t header_end = command.find_first_of(" \t", start);
+  if (header_end == std::string::npos) {
+    header_end = command.size();
+  }
+  if (command.find('?', start) < header_end) {
+    return command;
+  }
+  return command.insert(header_end, 1, '?');
+}
+
+static bool loadStep(ryml::ConstNodeRef node,
+                     const CommandParser::CommandTable &commands,
+                     Parameters parameters,
+                     const std::vector<Step> &previous,
+                     Step &step) {
+  step.name = hasChild(node, "name") ? nodeToString(node["name"])
+                                     : std::to_string(previous.size() + 1);
+  for (const Step &earlier : previous) {
+    if (earlier.name == step.name) {
+      spdlog::error("Step name {} used twice", step.name);
+      return false;
+    }
+  }
+  if (hasChild(node, "parameters")) {
+    readParameters(node["parameters"], parameters);
+  }
+
+  if (hasChild(node, "write")) {
+    for (ryml::ConstNodeRef entry : node["write"].children()) {
+      bool from_dialect;
+      std::string command =
+          resolveCommand(entry, commands, parameters, from_dialect);
+      if (command.empty()) {
+        return false;
+      }
+      step.writes.push_back(command);
+    }
+  }
+
+  if (hasChild(node, "measure")) {
+    // same query layout as the GUI measurement buttons
+    std::string get_result;
+    if (commands.Has("measurements.get_result")) {
+      get_result = commands.Get("measurements.get_result");
+    }
+    for (ryml::ConstNodeRef entry : node["measure"].children()) {
+      Measurement measurement;
+      bool from_dialect;
+      measurement.query =
+          resolveCommand(entry, commands, parameters, from_dialect);
+      if (measurement.query.empty()) {
+        return false;
+      }
+      // result query follows the command selecting the measurement
+      if (from_dialect && !get_result.empty()) {
+        measurement.query += ";" + get_result;
+      }
+      measurement.query = toQuery(measurement.query);
+      measurement.name = hasChild(entry, "name")
+                             ? nodeToString(entry["name"])
+                             : std::to_string(step.measurements.size() + 1);
+      if (hasChild(entry, "min")) {
+        measurement.min = std::stod(nodeToString(entry["min"]));
+      }
+      if (hasChild(entry, "max")) {
+        measurement.max = std::stod(nodeToString(entry["max"]));
+      }
+      step.measurements.push_back(measurement);
+    }
+  }
+
+  if (hasChild(node, "depends_on")) {
+    std::vector<std::string> names;
+    ryml::ConstNodeRef depends_on = node["depends_on"];
+    if (depends_on.is_seq()) {
+      for (ryml::ConstNodeRef name : depends_on.children()) {
+        names.push_back(nodeToString(name));
+      }
+    } else {
+      names.push_back(nodeToString(depends_on));
+    }
+    for (const std::string &name : names) {
+      auto found = std::find_if(
+          previous.begin(), previous.end(), [&](const Step &earlier) {
+            return earlier.name == name;
+          });
+      if (found == previous.end()) {
+        spdlog::error("Step {} depends on {}, which is not an earlier step",
+                      step.name,
+                      name);
+        return false;
+      }
+      step.depends_on.push_back(found - previous.begin());
+    }
+  }
+
+  if (hasChild(node, "wait_ms")) {
+    step.wait_ms = std::stoi(nodeToString(node["wait_ms"]));
+  }
+  return true;
+}
+
+bool loadSequence(const std::string &filename,
+                  const CommandParser::CommandTable &commands,
+                  const Parameters &overrides,
+                  Sequence &sequence) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) {
+    spdlog::error("Cannot open sequence file {}", filename);
+    return false;
+  }
+  const std::string contents((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+
+  sequence = Sequence();
+  try {
+    ryml::Tree tree = ryml::parse_in_arena(ryml::to_csubstr(contents));
+    ryml::ConstNodeRef root = tree.crootref();
+    if (!hasChild(root, "steps")) {
+      spdlog::error("Sequence {} has no steps", filename);
+      return false;
+    }
+    sequence.name =
+        hasChild(root, "name") ? nodeToString(root["name"]) : filename;
+
+    // command line overrides defaults of the file
+    Parameters parameters;
+    if (hasChild(root, "parameters")) {
+      readParameters(root["parameters"], parameters);
+    }
+    for (const auto &[name, value] : overrides) {
+      parameters[name] = value;
+    }
+
+    for (ryml::ConstNodeRef node : root["steps"].children()) {
+      Step step;
+      if (!loadStep(node, commands, parameters, sequence.steps, step)) {
+        spdlog::error("Error in step {} of {}", step.name, filename);
+        return false;
+      }
+      sequence.steps.push_back(std::move(step));
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Error parsing sequence {}:\n{}", filename, e.what());
+    return false;
+  }
+  return true;
+}
+
+std::string fillPlaceholders(std::string command,
+                             const Parameters &parameters) {
+  for (const auto &[name, value] : parameters) {
+    command = std::regex_replace(
+        command, std::regex("\\{" + name + "\\}"), value);
+  }
+  return command;
+}
+} // namespace scope_sequence
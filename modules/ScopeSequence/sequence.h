@@ -0,0 +1,73 @@
+/*********************************************************************
+ * \file   sequence.h
+ * \brief  Test sequence steps loaded from yaml and resolved against a
+ *         dialect file
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "CommandParser.hpp"
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace scope_sequence {
+using Parameters = std::map<std::string, std::string>;
+
+struct Measurement {
+  std::string name;
+  std::string query; // complete query, placeholders filled
+  double min = -std::numeric_limits<double>::infinity();
+  double max = std::numeric_limits<double>::infinity();
+};
+
+struct Step {
+  std::string name;
+  std::vector<std::string> writes;
+  std::vector<Measurement> measurements;
+  std::vector<size_t> depends_on; // indexes of earlier steps
+  int wait_ms = 0;                // pause after the step
+};
+
+struct Sequence {
+  std::string name;
+  std::vector<Step> steps;
+};
+
+/**
+ * Sequence file layout:
+ *
+ *   name: gain check
+ *   parameters:              # defaults, overridden from command line
+ *     channel_number: 1
+ *   steps:
+ *     - name: setup
+ *       parameters:          # for all entries of the step
+ *         scale_value: 5E-1
+ *       write:
+ *         - command: channels.scale.vertical   # path in dialect file
+ *         - scpi: ":TRIGger:SWEep NORMal"      # or plain SCPI
+ *     - name: acquire
+ *       write:
+ *         - command: acquisition.single
+ *     - name: measure
+ *       depends_on: [acquire] # wait until acquire is complete
+ *       measure:
+ *         - name: vrms
+ *           command: measurements.voltage_rms
+ *           min: 0.1
+ *           max: 1.5
+ *       wait_ms: 100
+ *
+ * Other keys of an entry are parameters of that entry only. All
+ * placeholders are filled here, so running needs no dialect lookups.
+ */
+bool loadSequence(const std::string &filename,
+                  const CommandParser::CommandTable &commands,
+                  const Parameters &overrides,
+                  Sequence &sequence);
+std::string fillPlaceholders(std::string command,
+                             const Parameters &parameters);
+} // namespace scope_sequence
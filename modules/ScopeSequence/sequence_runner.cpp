@@ -0,0 +1,237 @@
+/*********************************************************************
+ * \file   sequence_runner.cpp
+ * \brief  Definition of SequenceRunner class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "sequence_runner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <thread>
+
+namespace scope_sequence {
+using Clock = std::chrono::steady_clock;
+
+// SCPI replies to compound queries are separated with ';'
+static std::vector<std::string> splitReply(const std::string &reply) {
+  std::vector<std::string> fields;
+  std::stringstream stream(reply);
+  std::string field;
+  while (std::getline(stream, field, ';')) {
+    const size_t first = field.find_first_not_of(" \t\r\n");
+    const size_t last = field.find_last_not_of(" \t\r\n");
+    fields.push_back(first == std::string::npos
+                         ? ""
+                         : field.substr(first, last - first + 1));
+  }
+  return fields;
+}
+
+bool RunReport::Passed() const {
+  return this->completed &&
+         std::all_of(this->results.begin(),
+                     this->results.end(),
+                     [](const MeasurementResult &result) {
+                       return result.passed;
+                     });
+}
+
+SequenceRunner::SequenceRunner(SequenceTransport &transport)
+    : transport(transport) {}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+RunReport SequenceRunner::Run(const Sequence &sequence,
+                              ResultCallback callback) {
+  this->report = RunReport();
+  this->pending.clear();
+  this->pending_commands = 0;
+  this->pending_replies = 0;
+  this->pending_barrier = false;
+  this->stop_requested = false;
+
+  // steps whose writes may still be executed by the instrument
+  std::vector<bool> unconfirmed(sequence.steps.size(), false);
+  auto start = Clock::now();
+  bool success = true;
+
+  for (size_t i = 0; i < sequence.steps.size() && success; i++) {
+    const Step &step = sequence.steps[i];
+    if (this->stop_requested) {
+      spdlog::warn("Sequence stopped before step {}", step.name);
+      success = false;
+      break;
+    }
+    this->reply_fields.clear();
+
+    const bool barrier = std::any_of(
+        step.depends_on.begin(), step.depends_on.end(), [&](size_t index) {
+          return unconfirmed[index];
+        });
+    if (barrier) {
+      // *OPC? covers everything sent before it
+      success = success && Append("*OPC?", 1, true);
+      std::fill(unconfirmed.begin(), unconfirmed.begin() + i, false);
+      this->report.barriers++;
+    }
+    for (const std::string &command : step.writes) {
+      success = success && Append(command, 0, false);
+    }
+    unconfirmed[i] = !step.writes.empty();
+    for (const Measurement &measurement : step.measurements) {
+      success = success && Append(measurement.query, 1, false);
+    }
+    if (!success) {
+      break;
+    }
+
+    if (barrier || !step.measurements.empty()) {
+      success = Send();
+      if (!success) {
+        break;
+      }
+      if (barrier && !this->reply_fields.empty()) {
+        this->reply_fields.erase(this->reply_fields.begin());
+      }
+    }
+    if (!step.measurements.empty()) {
+      // one step is processed while the next one is sent, order is kept
+      if (this->processing.valid()) {
+        this->processing.wait();
+      }
+      this->processing = std::async(
+          std::launch::async,
+          [this, &step, &callback, fields = std::move(this->reply_fields)]() {
+            ProcessReplies(step, fields, callback);
+          });
+      this->reply_fields.clear();
+    }
+
+    if (step.wait_ms > 0) {
+      success = Send();
+      std::this_thread::sleep_for(std::chrono::milliseconds(step.wait_ms));
+    }
+  }
+
+  // run is finished when the instrument has executed all writes
+  const bool any_unconfirmed =
+      std::find(unconfirmed.begin(), unconfirmed.end(), true) !=
+      unconfirmed.end();
+  if (success && (any_unconfirmed || !this->pending.empty())) {
+    success = Append("*OPC?", 1, true) && Send();
+    this->report.barriers++;
+  }
+  if (this->processing.valid()) {
+    this->processing.wait();
+  }
+
+  this->report.completed = success;
+  this->report.elapsed_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  return this->report;
+}
+
+void SequenceRunner::Stop() {
+  this->stop_requested = true;
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+// adds command to pending message, sends the message first when full
+bool SequenceRunner::Append(const std::string &command,
+                            size_t replies,
+                            bool barrier) {
+  if (!this->pending.empty() &&
+      this->pending.size() + 1 + command.size() > MAX_MESSAGE_LENGTH &&
+      !Send()) {
+    return false;
+  }
+  if (!this->pending.empty()) {
+    this->pending += ';';
+  }
+  this->pending += command;
+  this->pending_commands++;
+  this->pending_replies += replies;
+  this->pending_barrier = this->pending_barrier || barrier;
+  return true;
+}
+
+// sends pending message, reply fields are added to reply_fields
+bool SequenceRunner::Send() {
+  if (this->pending.empty()) {
+    return true;
+  }
+
+  bool success;
+  if (this->pending_replies == 0) {
+    success = this->transport.Write(this->pending);
+  } else {
+    std::string reply;
+    success =
+        this->transport.Query(this->pending, this->pending_barrier, reply);
+    if (success) {
+      std::vector<std::string> fields = splitReply(reply);
+      this->reply_fields.insert(
+          this->reply_fields.end(), fields.begin(), fields.end());
+    }
+  }
+
+  if (!success) {
+    spdlog::error("Sequence message failed: {}", this->pending);
+  }
+  this->report.commands += this->pending_commands;
+  this->report.messages++;
+  this->pending.clear();
+  this->pending_commands = 0;
+  this->pending_replies = 0;
+  this->pending_barrier = false;
+  return success;
+}
+
+void SequenceRunner::ProcessReplies(const Step &step,
+                                    const std::vector<std::string> &fields,
+                                    const ResultCallback &callback) {
+  if (fields.size() != step.measurements.size()) {
+    spdlog::error("Step {} expected {} results, got {}",
+                  step.name,
+                  step.measurements.size(),
+                  fields.size());
+  }
+
+  for (size_t i = 0; i < step.measurements.size(); i++) {
+    const Measurement &measurement = step.measurements[i];
+    MeasurementResult result;
+    result.step = step.name;
+    result.name = measurement.name;
+    result.min = measurement.min;
+    result.max = measurement.max;
+    if (i < fields.size()) {
+      result.reply = fields[i];
+      char *end;
+      result.value = std::strtod(result.reply.c_str(), &end);
+      result.valid = end != result.reply.c_str() &&
+                     std::abs(result.value) < NOT_A_MEASUREMENT;
+    }
+    result.passed = result.valid && result.value >= measurement.min &&
+                    result.value <= measurement.max;
+
+    this->report.results.push_back(result);
+    if (callback) {
+      callback(result);
+    }
+  }
+}
+/*
+ *   PRIVATE METHODS END
+ */
+} // namespace scope_sequence
@@ -0,0 +1,93 @@
+/*********************************************************************
+ * \file   sequence_runner.h
+ * \brief  Pipelined execution of test sequences
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "sequence.h"
+#include <atomic>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace scope_sequence {
+// longest combined message, instruments have limited input buffers
+constexpr size_t MAX_MESSAGE_LENGTH = 1024;
+// SCPI "no measurement available" value
+constexpr double NOT_A_MEASUREMENT = 9.9e37;
+
+struct MeasurementResult {
+  std::string step;
+  std::string name;
+  std::string reply;
+  double value = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  bool valid = false;
+  bool passed = false;
+};
+
+struct RunReport {
+  std::vector<MeasurementResult> results;
+  size_t commands = 0; // SCPI commands sent
+  size_t messages = 0; // writes to the instrument carrying them
+  size_t barriers = 0; // *OPC? waits
+  double elapsed_ms = 0.0;
+  bool completed = false;
+
+  bool Passed() const;
+};
+
+/**
+ * Instrument side of the runner, messages are sent as built.
+ */
+class SequenceTransport {
+public:
+  virtual ~SequenceTransport() = default;
+
+  virtual bool Write(const std::string &message) = 0;
+  // barrier messages end with *OPC?, which may wait for long operations
+  virtual bool
+  Query(const std::string &message, bool barrier, std::string &reply) = 0;
+};
+
+/**
+ * Runs steps keeping as few round trips as possible. Writes are joined
+ * with ';' into one message and sent together with the next measurement
+ * queries, or when the message gets full. *OPC? is added only before a
+ * step depending on an earlier step whose writes were not confirmed yet,
+ * and in the same message as that step's queries when it has any. Replies
+ * are converted and checked against limits in a background task while
+ * the next steps are already being sent.
+ */
+class SequenceRunner {
+public:
+  using ResultCallback = std::function<void(const MeasurementResult &)>;
+
+  explicit SequenceRunner(SequenceTransport &transport);
+
+  // callback is called from the processing task, in step order
+  RunReport Run(const Sequence &sequence, ResultCallback callback = nullptr);
+  void Stop();
+
+private:
+  bool Append(const std::string &command, size_t replies, bool barrier);
+  bool Send();
+  void ProcessReplies(const Step &step,
+                      const std::vector<std::string> &fields,
+                      const ResultCallback &callback);
+
+  SequenceTransport &transport;
+  std::string pending; // joined commands not sent yet
+  size_t pending_commands = 0;
+  size_t pending_replies = 0; // reply fields expected for pending
+  bool pending_barrier = false;
+  std::vector<std::string> reply_fields; // of the current step
+  RunReport report;
+  std::future<void> processing;
+  std::atomic<bool> stop_requested{false};
+};
+} // namespace scope_sequence
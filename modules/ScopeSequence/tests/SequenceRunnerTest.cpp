@@ -0,0 +1,237 @@
+/*********************************************************************
+ * \file   SequenceRunnerTest.cpp
+ * \brief  Unit tests of message building and reply routing of
+ *         SequenceRunner
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TestSupport.hpp"
+#include "sequence_runner.h"
+#include <map>
+#include <sstream>
+
+using namespace scope_sequence;
+
+/**
+ * Records messages and answers every query of a message, *OPC? with 1,
+ * measurements with the value set for them or 0.
+ */
+class FakeTransport : public SequenceTransport {
+public:
+  struct Message {
+    std::string text;
+    bool query = false;
+    bool barrier = false;
+  };
+
+  bool Write(const std::string &message) override {
+    this->messages.push_back({message, false, false});
+    return this->messages.size() != this->fail_message;
+  }
+
+  bool Query(const std::string &message,
+             bool barrier,
+             std::string &reply) override {
+    this->messages.push_back({message, true, barrier});
+    std::stringstream stream(message);
+    std::string command;
+    while (std::getline(stream, command, ';')) {
+      if (command.find('?') == std::string::npos) {
+        continue;
+      }
+      if (!reply.empty()) {
+        reply += ';';
+      }
+      if (command == "*OPC?") {
+        reply += "1";
+      } else {
+        auto found = this->values.find(command);
+        reply += found != this->values.end() ? found->second : "0";
+      }
+    }
+    reply += '\n';
+    return this->messages.size() != this->fail_message;
+  }
+
+  std::vector<Message> messages;
+  std::map<std::string, std::string> values;
+  size_t fail_message = 0; // 1-based, 0 never fails
+};
+
+static Measurement measurement(const std::string &name,
+                               const std::string &query,
+                               double min,
+                               double max) {
+  Measurement result;
+  result.name = name;
+  result.query = query;
+  result.min = min;
+  result.max = max;
+  return result;
+}
+
+static std::vector<std::string> texts(const FakeTransport &transport) {
+  std::vector<std::string> result;
+  for (const auto &message : transport.messages) {
+    result.push_back(message.text);
+  }
+  return result;
+}
+
+// writes are joined with the queries of the step, last writes are confirmed
+static void testJoining() {
+  Sequence sequence;
+  sequence.steps.resize(2);
+  sequence.steps[0].name = "setup";
+  sequence.steps[0].writes = {":CHANnel1:SCALe 5E-1", ":TRIGger:SWEep NORMal"};
+  sequence.steps[0].measurements = {
+      measurement("vrms", ":MEASure:VRMS?", 0.1, 1.5)};
+  sequence.steps[1].name = "run";
+  sequence.steps[1].writes = {":RUN"};
+
+  FakeTransport transport;
+  transport.values[":MEASure:VRMS?"] = "7.07E-1";
+  RunReport report = SequenceRunner(transport).Run(sequence);
+
+  CHECK((texts(transport) ==
+         std::vector<std::string>{
+             ":CHANnel1:SCALe 5E-1;:TRIGger:SWEep NORMal;:MEASure:VRMS?",
+             ":RUN;*OPC?"}));
+  CHECK(transport.messages.size() == 2 && transport.messages[1].barrier &&
+        !transport.messages[0].barrier);
+  CHECK(report.completed && report.Passed());
+  CHECK(report.commands == 5 && report.messages == 2 && report.barriers == 1);
+  CHECK(report.results.size() == 1);
+  if (report.results.size() == 1) {
+    CHECK(report.results[0].step == "setup");
+    CHECK_NEAR(report.results[0].value, 0.707, 1e-9);
+  }
+}
+
+// message is sent when the next command would make it too long
+static void testSplit() {
+  const std::string long_write = ":DISPlay:TEXT \"" + std::string(600, 'x') +
+                                 "\"";
+  const std::string long_query = ":MEASure:VRMS? " + std::string(300, 'y');
+  Sequence sequence;
+  sequence.steps.resize(1);
+  sequence.steps[0].writes = {long_write, long_write};
+  // second query overflows the message in the middle of the step
+  sequence.steps[0].measurements = {measurement("a", long_query, 0.5, 1.5),
+                                    measurement("b", long_query, 1.5, 2.5),
+                                    measurement("c", ":MEASure:FREQuency?",
+                                                999.0,
+                                                1001.0)};
+
+  FakeTransport transport;
+  transport.values[long_query] = "1";
+  transport.values[":MEASure:FREQuency?"] = "1E3";
+  RunReport report = SequenceRunner(transport).Run(sequence);
+
+  CHECK(transport.messages.size() == 4);
+  for (const auto &message : transport.messages) {
+    CHECK(message.text.size() <= MAX_MESSAGE_LENGTH);
+  }
+  if (transport.messages.size() == 4) {
+    CHECK(transport.messages[0].text == long_write &&
+          !transport.messages[0].query);
+    CHECK(transport.messages[1].text == long_write + ";" + long_query &&
+          transport.messages[1].query);
+    CHECK(transport.messages[2].text == long_query + ";:MEASure:FREQuency?");
+    CHECK(transport.messages[3].text == "*OPC?");
+  }
+  // replies of both query messages belong to the step, in order
+  CHECK(report.results.size() == 3);
+  if (report.results.size() == 3) {
+    CHECK(report.results[0].passed && report.results[0].name == "a");
+    CHECK(!report.results[1].passed && report.results[1].name == "b");
+    CHECK(report.results[2].passed && report.results[2].value == 1000.0);
+  }
+  CHECK(report.commands == 6 && report.messages == 4);
+}
+
+// *OPC? only where a dependency is unconfirmed, its reply is not a result
+static void testBarriers() {
+  Sequence sequence;
+  sequence.steps.resize(5);
+  sequence.steps[0].name = "acquire";
+  sequence.steps[0].writes = {":SINGle"};
+  // barrier only step, nothing to send with it
+  sequence.steps[1].name = "wait";
+  sequence.steps[1].depends_on = {0};
+  sequence.steps[2].name = "attenuate";
+  sequence.steps[2].writes = {":CHANnel1:SCALe 2E-1", ":SINGle"};
+  sequence.steps[3].name = "measure";
+  sequence.steps[3].depends_on = {2};
+  sequence.steps[3].measurements = {
+      measurement("vrms", ":MEASure:VRMS?", 0.1, 1.5),
+      measurement("frequency", ":MEASure:FREQuency?", 990.0, 1010.0)};
+  // writes of acquire were confirmed by the first barrier
+  sequence.steps[4].name = "measure again";
+  sequence.steps[4].depends_on = {0};
+  sequence.steps[4].measurements = {
+      measurement("vrms", ":MEASure:VRMS?", 0.1, 1.5)};
+
+  FakeTransport transport;
+  transport.values[":MEASure:VRMS?"] = "5E-1";
+  transport.values[":MEASure:FREQuency?"] = "1E3";
+  std::vector<std::string> names;
+  RunReport report = SequenceRunner(transport).Run(
+      sequence,
+      [&](const MeasurementResult &result) { names.push_back(result.name); });
+
+  CHECK((texts(transport) ==
+         std::vector<std::string>{
+             ":SINGle;*OPC?",
+             ":CHANnel1:SCALe 2E-1;:SINGle;*OPC?;:MEASure:VRMS?;"
+             ":MEASure:FREQuency?",
+             ":MEASure:VRMS?"}));
+  CHECK(transport.messages.size() == 3 && transport.messages[0].barrier &&
+        transport.messages[1].barrier && !transport.messages[2].barrier);
+  // nothing is left unconfirmed, so no final *OPC?
+  CHECK(report.barriers == 2);
+  CHECK(report.Passed());
+  CHECK((names == std::vector<std::string>{"vrms", "frequency", "vrms"}));
+  if (report.results.size() == 3) {
+    CHECK(report.results[0].value == 0.5 &&
+          report.results[0].step == "measure");
+    CHECK(report.results[1].value == 1000.0);
+    CHECK(report.results[2].step == "measure again");
+  }
+}
+
+static void testFailures() {
+  Sequence sequence;
+  sequence.steps.resize(2);
+  sequence.steps[0].writes = {":SINGle"};
+  sequence.steps[0].measurements = {
+      measurement("vrms", ":MEASure:VRMS?", 0.1, 1.5)};
+  sequence.steps[1].measurements = {
+      measurement("vrms", ":MEASure:VRMS?", 0.1, 1.5)};
+
+  // failed message ends the run
+  FakeTransport failing;
+  failing.fail_message = 1;
+  RunReport report = SequenceRunner(failing).Run(sequence);
+  CHECK(!report.completed && !report.Passed());
+  CHECK(failing.messages.size() == 1);
+
+  // no measurement available is not a valid value
+  FakeTransport transport;
+  transport.values[":MEASure:VRMS?"] = "9.9E37";
+  report = SequenceRunner(transport).Run(sequence);
+  CHECK(report.completed && !report.Passed());
+  CHECK(report.results.size() == 2);
+  if (report.results.size() == 2) {
+    CHECK(!report.results[0].valid && report.results[0].reply == "9.9E37");
+  }
+}
+
+int main() {
+  testJoining();
+  testSplit();
+  testBarriers();
+  testFailures();
+  return TestSupport::Result();
+}
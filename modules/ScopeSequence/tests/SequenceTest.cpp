@@ -0,0 +1,179 @@
+/*********************************************************************
+ * \file   SequenceTest.cpp
+ * \brief  Unit tests of test sequence loading
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TestSupport.hpp"
+#include "sequence.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+using namespace scope_sequence;
+
+static const std::string FILENAME =
+    (std::filesystem::temp_directory_path() / "SequenceTest.yml").string();
+
+static std::shared_ptr<const CommandParser::CommandTable>
+makeCommands(const std::string &get_result) {
+  return CommandParser::CommandTable::FromBuffer(
+      CommandParser::CommandTable::Compile(
+          {{"channels.scale.vertical",
+            ":CHANnel{channel_number}:SCALe {scale_value}"},
+           {"acquisition.single", ":SINGle"},
+           {"measurements.get_result", get_result},
+           {"measurements.voltage_rms",
+            ":MEASure:VRMS CHANnel{channel_number}"}},
+          1),
+      1);
+}
+
+static bool load(const std::string &contents,
+                 const std::string &get_result,
+                 const Parameters &overrides,
+                 Sequence &sequence) {
+  {
+    std::ofstream file(FILENAME, std::ios::trunc);
+    file << contents;
+  }
+  return loadSequence(
+      FILENAME, *makeCommands(get_result), overrides, sequence);
+}
+
+static const char *SEQUENCE = "name: gain check\n"
+                              "parameters:\n"
+                              "  channel_number: 1\n"
+                              "steps:\n"
+                              "  - name: setup\n"
+                              "    parameters:\n"
+                              "      scale_value: 5E-1\n"
+                              "    write:\n"
+                              "      - command: channels.scale.vertical\n"
+                              "      - command: channels.scale.vertical\n"
+                              "        scale_value: 2E-1\n"
+                              "      - scpi: \":TRIGger:SWEep NORMal\"\n"
+                              "  - name: acquire\n"
+                              "    write:\n"
+                              "      - command: acquisition.single\n"
+                              "  - name: measure\n"
+                              "    depends_on: [acquire]\n"
+                              "    measure:\n"
+                              "      - name: vrms\n"
+                              "        command: measurements.voltage_rms\n"
+                              "        min: 0.1\n"
+                              "        max: 1.5\n"
+                              "      - \":MEASure:FREQuency\"\n"
+                              "    wait_ms: 100\n";
+
+static void testLoad() {
+  Sequence sequence;
+  CHECK(load(SEQUENCE, "", {}, sequence));
+  CHECK(sequence.name == "gain check");
+  CHECK(sequence.steps.size() == 3);
+  if (sequence.steps.size() != 3) {
+    return;
+  }
+
+  // entry parameters override step ones, step ones the sequence defaults
+  const Step &setup = sequence.steps[0];
+  CHECK(setup.name == "setup");
+  CHECK((setup.writes == std::vector<std::string>{
+                             ":CHANnel1:SCALe 5E-1",
+                             ":CHANnel1:SCALe 2E-1",
+                             ":TRIGger:SWEep NORMal"}));
+  CHECK(setup.measurements.empty() && setup.depends_on.empty());
+
+  const Step &measure = sequence.steps[2];
+  CHECK((measure.depends_on == std::vector<size_t>{1}));
+  CHECK(measure.wait_ms == 100);
+  CHECK(measure.measurements.size() == 2);
+  if (measure.measurements.size() == 2) {
+    CHECK(measure.measurements[0].name == "vrms");
+    // '?' belongs to the header, not after the parameter
+    CHECK(measure.measurements[0].query == ":MEASure:VRMS? CHANnel1");
+    CHECK(measure.measurements[0].min == 0.1);
+    CHECK(measure.measurements[0].max == 1.5);
+    CHECK(measure.measurements[1].name == "2");
+    CHECK(measure.measurements[1].query == ":MEASure:FREQuency?");
+    CHECK(std::isinf(measure.measurements[1].max));
+  }
+}
+
+// command line parameters and dialects with a separate result query
+static void testOverridesAndResultQuery() {
+  Sequence sequence;
+  CHECK(load(SEQUENCE, ":MEASure:RESult", {{"channel_number", "3"}}, sequence));
+  CHECK(sequence.steps.size() == 3);
+  if (sequence.steps.size() == 3) {
+    CHECK(sequence.steps[0].writes[0] == ":CHANnel3:SCALe 5E-1");
+    // measurement is selected by a command, only the result is queried
+    CHECK(sequence.steps[2].measurements[0].query ==
+          ":MEASure:VRMS CHANnel3;:MEASure:RESult?");
+    // plain SCPI queries are sent as written
+    CHECK(sequence.steps[2].measurements[1].query == ":MEASure:FREQuency?");
+  }
+  CHECK(fillPlaceholders("{a}{b}{a}", {{"a", "1"}, {"b", "2"}}) == "121");
+}
+
+// '?' is added to the header of commands with parameters
+static void testQueryHeader() {
+  Sequence sequence;
+  CHECK(load("steps:\n  - measure:\n"
+             "      - \":MEASure:VPP CHANnel2\"\n"
+             "      - \":MEASure:FREQuency? CHANnel2\"\n"
+             "      - \"*OPC?\"\n",
+             "",
+             {},
+             sequence));
+  CHECK(sequence.steps.size() == 1);
+  if (sequence.steps.size() == 1 &&
+      sequence.steps[0].measurements.size() == 3) {
+    const std::vector<Measurement> &measurements =
+        sequence.steps[0].measurements;
+    CHECK(measurements[0].query == ":MEASure:VPP? CHANnel2");
+    CHECK(measurements[1].query == ":MEASure:FREQuency? CHANnel2");
+    CHECK(measurements[2].query == "*OPC?");
+  }
+}
+
+static void testRejectsErrors() {
+  Sequence sequence;
+  // unknown dialect command
+  CHECK(!load("steps:\n  - write:\n      - command: utils.missing\n",
+              "",
+              {},
+              sequence));
+  // placeholder without a value
+  CHECK(!load("steps:\n  - write:\n      - command: acquisition.single\n"
+              "      - command: channels.scale.vertical\n",
+              "",
+              {},
+              sequence));
+  // dependency on a later step
+  CHECK(!load("steps:\n  - name: a\n    depends_on: b\n"
+              "    write: [\":SINGle\"]\n"
+              "  - name: b\n    write: [\":RUN\"]\n",
+              "",
+              {},
+              sequence));
+  // step names identify dependencies
+  CHECK(!load("steps:\n  - name: a\n    write: [\":SINGle\"]\n"
+              "  - name: a\n    write: [\":RUN\"]\n",
+              "",
+              {},
+              sequence));
+  CHECK(!load("name: no steps\n", "", {}, sequence));
+  CHECK(!load("steps: [\n", "", {}, sequence));
+  std::filesystem::remove(FILENAME);
+  CHECK(!loadSequence(FILENAME, *makeCommands(""), {}, sequence));
+}
+
+int main() {
+  testLoad();
+  testOverridesAndResultQuery();
+  testQueryHeader();
+  testRejectsErrors();
+  return TestSupport::Result();
+}
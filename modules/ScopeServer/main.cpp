@@ -0,0 +1,81 @@
+#include "scope_instrument.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+
+static scope_server::ScopeServer *running_server = nullptr;
+
+static void handleSignal(int) {
+  if (running_server != nullptr) {
+    running_server->Stop();
+  }
+}
+
+static void printUsage(const char *program) {
+  fmt::print("Usage: {} <resource string> [--unix PATH | --port N] "
+             "[--verbose]\n"
+             "Default: --unix /tmp/scope_server.sock\n",
+             program);
+}
+
+static bool parsePort(const char *text, uint16_t &port) {
+  char *end = nullptr;
+  errno = 0;
+  long value = std::strtol(text, &end, 10);
+  if (errno != 0 || end == text || *end != '\0' || value < 1 ||
+      value > 65535) {
+    return false;
+  }
+  port = static_cast<uint16_t>(value);
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::string resource_string = argv[1];
+  std::string unix_path = "/tmp/scope_server.sock";
+  uint16_t port = 0;
+  bool verbose = false;
+  for (int i = 2; i < argc; i++) {
+    std::string option = argv[i];
+    if (option == "--verbose") {
+      verbose = true;
+    } else if (option == "--unix" && i + 1 < argc) {
+      unix_path = argv[++i];
+    } else if (option == "--port" && i + 1 < argc) {
+      if (!parsePort(argv[++i], port)) {
+        fmt::print("Invalid port: {}, expected 1-65535\n", argv[i]);
+        return 1;
+      }
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  // per-command logging would slow down serving clients
+  spdlog::set_level(verbose ? spdlog::level::debug : spdlog::level::warn);
+
+  InstrumentControl::InstrumentControl scope;
+  if (!scope.Connect(resource_string.data())) {
+    return 1;
+  }
+
+  scope_server::ScopeInstrument instrument(scope);
+  scope_server::ScopeServer server(instrument);
+  if (port > 0 ? !server.ListenTcp(port) : !server.ListenUnix(unix_path)) {
+    return 1;
+  }
+
+  running_server = &server;
+  std::signal(SIGINT, handleSignal);
+  std::signal(SIGTERM, handleSignal);
+
+  server.Run();
+  spdlog::info("Server stopped");
+  return 0;
+}
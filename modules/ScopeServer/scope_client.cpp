@@ -0,0 +1,202 @@
+/*********************************************************************
+ * \file   scope_client.cpp
+ * \brief  Definition of ScopeClient class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "scope_client.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace scope_client {
+using scope_protocol::MessageType;
+
+ScopeClient::ScopeClient() {}
+
+ScopeClient::~ScopeClient() {
+  Disconnect();
+}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+bool ScopeClient::ConnectUnix(const std::string &path) {
+  sockaddr_un address = {};
+  if (path.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  std::copy(path.begin(), path.end(), address.sun_path);
+
+  this->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (this->fd < 0 ||
+      connect(this->fd, (sockaddr *)&address, sizeof(address)) < 0) {
+    Disconnect();
+    return false;
+  }
+  return true;
+}
+
+bool ScopeClient::ConnectTcp(uint16_t port) {
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  this->fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (this->fd < 0 ||
+      connect(this->fd, (sockaddr *)&address, sizeof(address)) < 0) {
+    Disconnect();
+    return false;
+  }
+  return true;
+}
+
+void ScopeClient::Disconnect() {
+  if (this->fd >= 0) {
+    close(this->fd);
+    this->fd = -1;
+  }
+}
+
+bool ScopeClient::Write(const std::string &command) {
+  Message reply;
+  return Request(MessageType::Write, command, reply);
+}
+
+bool ScopeClient::Query(const std::string &command, std::string &reply) {
+  Message message;
+  if (!Request(MessageType::Query, command, message)) {
+    return false;
+  }
+  reply.assign(message.payload.begin(), message.payload.end());
+  return true;
+}
+
+bool ScopeClient::QueryBlock(const std::string &command,
+                             std::vector<uint8_t> &block) {
+  Message message;
+  if (!Request(MessageType::BlockQuery, command, message)) {
+    return false;
+  }
+  block = std::move(message.payload);
+  return true;
+}
+
+bool ScopeClient::Subscribe(const std::string &command,
+                            int interval_ms,
+                            bool block,
+                            uint32_t &subscription_id) {
+  subscription_id = this->next_request_id;
+  Message reply;
+  return Request(MessageType::Subscribe,
+                 std::to_string(interval_ms) + (block ? " B " : " Q ") +
+                     command,
+                 reply);
+}
+
+bool ScopeClient::Unsubscribe(const std::string &command, bool block) {
+  Message reply;
+  return Request(
+      MessageType::Unsubscribe, (block ? "B " : "Q ") + command, reply);
+}
+
+bool ScopeClient::WaitForUpdate(Message &update) {
+  if (!this->updates.empty()) {
+    update = std::move(this->updates.front());
+    this->updates.pop_front();
+    return true;
+  }
+  return ReceiveFrame(update);
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+bool ScopeClient::Request(MessageType type,
+                          const std::string &payload,
+                          Message &reply) {
+  const uint32_t request_id = this->next_request_id++;
+  if (!SendFrame(type, request_id, payload)) {
+    return false;
+  }
+
+  while (ReceiveFrame(reply)) {
+    if (reply.header.request_id == request_id) {
+      return reply.header.type != MessageType::Error;
+    }
+    this->updates.push_back(std::move(reply)); // subscription update
+  }
+  return false;
+}
+
+bool ScopeClient::SendFrame(MessageType type,
+                            uint32_t request_id,
+                            const std::string &payload) {
+  scope_protocol::Header header;
+  header.type = type;
+  header.request_id = request_id;
+  header.payload_length = payload.size();
+  scope_protocol::HeaderBytes header_bytes =
+      scope_protocol::encodeHeader(header);
+
+  iovec parts[2] = {{header_bytes.data(), header_bytes.size()},
+                    {(void *)payload.data(), payload.size()}};
+  size_t remaining = header_bytes.size() + payload.size();
+  while (remaining > 0) {
+    msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = 2;
+    ssize_t sent = sendmsg(this->fd, &message, MSG_NOSIGNAL);
+    if (sent <= 0) {
+      return false;
+    }
+    remaining -= sent;
+    // advance over the bytes already sent
+    for (iovec &part : parts) {
+      size_t consumed = std::min<size_t>(part.iov_len, sent);
+      part.iov_base = (uint8_t *)part.iov_base + consumed;
+      part.iov_len -= consumed;
+      sent -= consumed;
+    }
+  }
+  return true;
+}
+
+bool ScopeClient::ReceiveFrame(Message &message) {
+  uint8_t header_bytes[scope_protocol::HEADER_SIZE];
+  if (!ReceiveExactly(header_bytes, sizeof(header_bytes))) {
+    return false;
+  }
+  message.header = scope_protocol::decodeHeader(header_bytes);
+  if (message.header.payload_length > scope_protocol::MAX_PAYLOAD_SIZE) {
+    return false;
+  }
+  message.payload.resize(message.header.payload_length);
+  return ReceiveExactly(message.payload.data(), message.payload.size());
+}
+
+bool ScopeClient::ReceiveExactly(uint8_t *destination, size_t size) {
+  while (size > 0) {
+    ssize_t received = recv(this->fd, destination, size, 0);
+    if (received <= 0) {
+      return false;
+    }
+    destination += received;
+    size -= received;
+  }
+  return true;
+}
+/*
+ *   PRIVATE METHODS END
+ */
+}; // namespace scope_client
@@ -0,0 +1,60 @@
+/*********************************************************************
+ * \file   scope_client.h
+ * \brief  Blocking client for the ScopeServer local control protocol
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "scope_protocol.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace scope_client {
+struct Message {
+  scope_protocol::Header header;
+  std::vector<uint8_t> payload;
+};
+
+/**
+ * Sends one request at a time and waits for its reply. Subscription
+ * updates arriving in the meantime are kept for WaitForUpdate.
+ */
+class ScopeClient {
+public:
+  ScopeClient();
+  ~ScopeClient();
+
+  bool ConnectUnix(const std::string &path);
+  bool ConnectTcp(uint16_t port);
+  void Disconnect();
+
+  bool Write(const std::string &command);
+  bool Query(const std::string &command, std::string &reply);
+  bool QueryBlock(const std::string &command, std::vector<uint8_t> &block);
+  bool Subscribe(const std::string &command,
+                 int interval_ms,
+                 bool block,
+                 uint32_t &subscription_id);
+  bool Unsubscribe(const std::string &command, bool block);
+  bool WaitForUpdate(Message &update);
+
+private:
+  bool Request(scope_protocol::MessageType type,
+               const std::string &payload,
+               Message &reply);
+  bool SendFrame(scope_protocol::MessageType type,
+                 uint32_t request_id,
+                 const std::string &payload);
+  bool ReceiveFrame(Message &message);
+  bool ReceiveExactly(uint8_t *destination, size_t size);
+
+  int fd = -1;
+  uint32_t next_request_id = 1;
+  std::deque<Message> updates;
+};
+}; // namespace scope_client
+
+// SCOPE_CLIENT_H
@@ -0,0 +1,47 @@
+/*********************************************************************
+ * \file   scope_instrument.cpp
+ * \brief  Definition of ScopeInstrument class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "scope_instrument.h"
+
+namespace scope_server {
+ScopeInstrument::ScopeInstrument(InstrumentControl::InstrumentControl &scope)
+    : scope(scope) {}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+bool ScopeInstrument::Write(const std::string &command) {
+  return this->scope.Write(command.c_str());
+}
+
+/**
+ * Reply is read until END instead of into the session buffer, which would
+ * cut replies longer than BUFFER_SIZE_B.
+ */
+bool ScopeInstrument::Query(const std::string &command, std::string &reply) {
+  auto session = this->scope.LockSession();
+  if (!this->scope.Write(command.c_str()) ||
+      !this->scope.ReadResponse(this->response, BUFFER_SIZE_B)) {
+    return false;
+  }
+  reply.assign(this->response.begin(), this->response.end());
+  return true;
+}
+
+bool ScopeInstrument::QueryBlock(const std::string &command,
+                                 std::vector<uint8_t> &block) {
+  auto session = this->scope.LockSession();
+  return this->scope.Write(command.c_str()) && this->scope.ReadBlock(block);
+}
+
+void ScopeInstrument::Clear() {
+  this->scope.ViClear();
+}
+/*
+ * PUBLIC METHODS END
+ */
+}; // namespace scope_server
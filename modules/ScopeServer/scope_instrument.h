@@ -0,0 +1,29 @@
+/*********************************************************************
+ * \file   scope_instrument.h
+ * \brief  Server requests executed over an instrument session
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "InstrumentControl.hpp"
+#include "scope_server.h"
+
+namespace scope_server {
+class ScopeInstrument : public Instrument {
+public:
+  explicit ScopeInstrument(InstrumentControl::InstrumentControl &scope);
+
+  bool Write(const std::string &command) override;
+  bool Query(const std::string &command, std::string &reply) override;
+  bool QueryBlock(const std::string &command,
+                  std::vector<uint8_t> &block) override;
+  void Clear() override;
+
+private:
+  InstrumentControl::InstrumentControl &scope;
+  std::vector<ViByte> response;
+};
+}; // namespace scope_server
+
+// SCOPE_INSTRUMENT_H
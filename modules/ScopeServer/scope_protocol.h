@@ -0,0 +1,74 @@
+/*********************************************************************
+ * \file   scope_protocol.h
+ * \brief  Framing of the ScopeServer local control protocol
+ *
+ * Every message is a 9 byte header followed by payload:
+ *   uint32 payload length (big endian)
+ *   uint8  message type
+ *   uint32 request id (big endian), echoed back in replies
+ *
+ * Requests:  W - write, Q - text query, B - binary block query,
+ *            S - subscribe ("<interval ms> <Q|B> <query>"),
+ *            U - unsubscribe ("<Q|B> <query>").
+ * Replies:   A - ack, R - text reply, K - binary block, E - error text.
+ * Subscription updates are R/K frames carrying the subscribe request id.
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace scope_protocol {
+constexpr size_t HEADER_SIZE = 9;
+constexpr uint32_t MAX_PAYLOAD_SIZE = 64 * 1024 * 1024;
+
+enum class MessageType : uint8_t {
+  Write = 'W',
+  Query = 'Q',
+  BlockQuery = 'B',
+  Subscribe = 'S',
+  Unsubscribe = 'U',
+  Ack = 'A',
+  Reply = 'R',
+  Block = 'K',
+  Error = 'E'
+};
+
+struct Header {
+  uint32_t payload_length = 0;
+  MessageType type = MessageType::Error;
+  uint32_t request_id = 0;
+};
+
+using HeaderBytes = std::array<uint8_t, HEADER_SIZE>;
+
+inline HeaderBytes encodeHeader(const Header &header) {
+  HeaderBytes bytes;
+  bytes[0] = header.payload_length >> 24;
+  bytes[1] = header.payload_length >> 16;
+  bytes[2] = header.payload_length >> 8;
+  bytes[3] = header.payload_length;
+  bytes[4] = static_cast<uint8_t>(header.type);
+  bytes[5] = header.request_id >> 24;
+  bytes[6] = header.request_id >> 16;
+  bytes[7] = header.request_id >> 8;
+  bytes[8] = header.request_id;
+  return bytes;
+}
+
+inline Header decodeHeader(const uint8_t *bytes) {
+  Header header;
+  header.payload_length = (uint32_t)bytes[0] << 24 |
+                          (uint32_t)bytes[1] << 16 |
+                          (uint32_t)bytes[2] << 8 | bytes[3];
+  header.type = static_cast<MessageType>(bytes[4]);
+  header.request_id = (uint32_t)bytes[5] << 24 | (uint32_t)bytes[6] << 16 |
+                      (uint32_t)bytes[7] << 8 | bytes[8];
+  return header;
+}
+}; // namespace scope_protocol
+
+// SCOPE_PROTOCOL_H
@@ -0,0 +1,574 @@
+/*********************************************************************
+ * \file   scope_server.cpp
+ * \brief  Definition of ScopeServer class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "scope_server.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace scope_server {
+using scope_protocol::MessageType;
+
+static bool setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static bool isQuery(MessageType type) {
+  return type == MessageType::Query || type == MessageType::BlockQuery;
+}
+
+static std::string subscriptionKey(MessageType type,
+                                   const std::string &command) {
+  return static_cast<char>(type) + command;
+}
+
+// shared poll runs at the fastest rate requested by current subscribers
+static std::chrono::milliseconds
+fastestInterval(const Subscription &subscription) {
+  std::chrono::milliseconds interval = std::chrono::milliseconds::max();
+  for (auto &[fd, subscriber] : subscription.subscribers) {
+    interval = std::min(interval, subscriber.interval);
+  }
+  return interval;
+}
+
+ScopeServer::ScopeServer(Instrument &scope) : scope(scope) {}
+
+ScopeServer::~ScopeServer() {
+  for (auto &[fd, client] : this->clients) {
+    close(fd);
+  }
+  if (this->listen_fd >= 0) {
+    close(this->listen_fd);
+  }
+  if (!this->unix_path.empty()) {
+    unlink(this->unix_path.c_str());
+  }
+}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+bool ScopeServer::ListenUnix(const std::string &path) {
+  sockaddr_un address = {};
+  if (path.size() >= sizeof(address.sun_path)) {
+    spdlog::error("Socket path too long: {}", path);
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  std::copy(path.begin(), path.end(), address.sun_path);
+
+  this->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path.c_str()); // stale socket left by previous run
+  if (this->listen_fd < 0 ||
+      bind(this->listen_fd, (sockaddr *)&address, sizeof(address)) < 0 ||
+      listen(this->listen_fd, SOMAXCONN) < 0 ||
+      !setNonBlocking(this->listen_fd)) {
+    spdlog::error("Could not listen on {}: {}", path, std::strerror(errno));
+    return false;
+  }
+
+  this->unix_path = path;
+  spdlog::info("Listening on unix socket {}", path);
+  return true;
+}
+
+bool ScopeServer::ListenTcp(uint16_t port) {
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local clients only
+
+  this->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  int reuse = 1;
+  setsockopt(
+      this->listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (this->listen_fd < 0 ||
+      bind(this->listen_fd, (sockaddr *)&address, sizeof(address)) < 0 ||
+      listen(this->listen_fd, SOMAXCONN) < 0 ||
+      !setNonBlocking(this->listen_fd)) {
+    spdlog::error(
+        "Could not listen on port {}: {}", port, std::strerror(errno));
+    return false;
+  }
+
+  spdlog::info("Listening on 127.0.0.1:{}", port);
+  return true;
+}
+
+void ScopeServer::Run() {
+  this->running = true;
+  std::vector<pollfd> poll_fds;
+
+  while (this->running) {
+    poll_fds.clear();
+    poll_fds.push_back({this->listen_fd, POLLIN, 0});
+    for (auto &[fd, client] : this->clients) {
+      // client sending faster than it is served waits in its socket
+      short events = client.requests.size() < MAX_QUEUED_REQUESTS ? POLLIN : 0;
+      if (!client.output.empty()) {
+        events |= POLLOUT;
+      }
+      poll_fds.push_back({fd, events, 0});
+    }
+
+    // do not sleep while there is instrument work waiting
+    int timeout_ms = HasPendingRequests() ? 0 : NextPollTimeoutMs();
+    if (poll(poll_fds.data(), poll_fds.size(), timeout_ms) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      spdlog::error("poll failed: {}", std::strerror(errno));
+      break;
+    }
+
+    if (poll_fds[0].revents & POLLIN) {
+      AcceptClient();
+    }
+    for (size_t i = 1; i < poll_fds.size(); i++) {
+      auto it = this->clients.find(poll_fds[i].fd);
+      if (it == this->clients.end()) {
+        continue;
+      }
+      bool alive = !(poll_fds[i].revents & (POLLERR | POLLNVAL));
+      if (alive && (poll_fds[i].revents & (POLLIN | POLLHUP))) {
+        alive = ReceiveFromClient(it->second);
+      }
+      if (alive && (poll_fds[i].revents & POLLOUT)) {
+        alive = SendToClient(it->second);
+      }
+      if (!alive) {
+        CloseClient(poll_fds[i].fd);
+      }
+    }
+
+    ServeNextRequest();
+    PollSubscriptions();
+    CloseFailedClients();
+  }
+}
+
+void ScopeServer::Stop() {
+  this->running = false;
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+void ScopeServer::AcceptClient() {
+  int fd;
+  while ((fd = accept(this->listen_fd, nullptr, nullptr)) >= 0) {
+    setNonBlocking(fd);
+    this->clients[fd].fd = fd;
+    spdlog::info("Client {} connected", fd);
+  }
+}
+
+bool ScopeServer::ReceiveFromClient(Client &client) {
+  uint8_t chunk[65536];
+  // requests over the limit stay in the socket until the queue has room
+  while (client.requests.size() < MAX_QUEUED_REQUESTS) {
+    ssize_t received = recv(client.fd, chunk, sizeof(chunk), 0);
+    if (received == 0) {
+      return false;
+    }
+    if (received < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    client.input.insert(client.input.end(), chunk, chunk + received);
+    if (!SplitRequests(client)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// moves complete frames from input to requests
+bool ScopeServer::SplitRequests(Client &client) {
+  size_t offset = 0;
+  while (client.input.size() - offset >= scope_protocol::HEADER_SIZE) {
+    scope_protocol::Header header =
+        scope_protocol::decodeHeader(client.input.data() + offset);
+    if (header.payload_length > scope_protocol::MAX_PAYLOAD_SIZE) {
+      spdlog::error("Client {} sent oversized frame", client.fd);
+      return false;
+    }
+    size_t frame_size = scope_protocol::HEADER_SIZE + header.payload_length;
+    if (client.input.size() - offset < frame_size) {
+      break;
+    }
+    const char *payload = (const char *)client.input.data() + offset +
+                          scope_protocol::HEADER_SIZE;
+    client.requests.push_back(
+        {header.type,
+         header.request_id,
+         std::string(payload, header.payload_length)});
+    offset += frame_size;
+  }
+  client.input.erase(client.input.begin(), client.input.begin() + offset);
+  return true;
+}
+
+bool ScopeServer::SendToClient(Client &client) {
+  while (!client.output.empty()) {
+    OutgoingFrame &frame = client.output.front();
+    const size_t payload_size = frame.payload ? frame.payload->size() : 0;
+    const size_t frame_size = scope_protocol::HEADER_SIZE + payload_size;
+
+    // header and shared payload go out in one call, payload is not copied
+    iovec parts[2];
+    int part_count = 0;
+    if (frame.offset < scope_protocol::HEADER_SIZE) {
+      parts[part_count++] = {frame.header.data() + frame.offset,
+                             scope_protocol::HEADER_SIZE - frame.offset};
+    }
+    if (payload_size > 0) {
+      size_t payload_offset =
+          frame.offset > scope_protocol::HEADER_SIZE
+              ? frame.offset - scope_protocol::HEADER_SIZE
+              : 0;
+      parts[part_count++] = {(void *)(frame.payload->data() + payload_offset),
+                             payload_size - payload_offset};
+    }
+
+    msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = part_count;
+    ssize_t sent = sendmsg(client.fd, &message, MSG_NOSIGNAL);
+    if (sent < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    frame.offset += sent;
+    if (frame.offset < frame_size) {
+      return true; // socket buffer full, continue on POLLOUT
+    }
+    client.output.pop_front();
+  }
+  return true;
+}
+
+void ScopeServer::CloseClient(int fd) {
+  for (auto it = this->subscriptions.begin();
+       it != this->subscriptions.end();) {
+    const std::string key = (it++)->first; // advanced before erasing
+    RemoveSubscriber(fd, key);
+  }
+  close(fd);
+  this->clients.erase(fd);
+  spdlog::info("Client {} disconnected", fd);
+}
+
+void ScopeServer::CloseFailedClients() {
+  for (auto it = this->clients.begin(); it != this->clients.end();) {
+    const int fd = it->first;
+    const bool failed = (it++)->second.failed;
+    if (failed) {
+      CloseClient(fd);
+    }
+  }
+}
+
+void ScopeServer::RemoveSubscriber(int fd, const std::string &key) {
+  auto it = this->subscriptions.find(key);
+  if (it == this->subscriptions.end()) {
+    return;
+  }
+  it->second.subscribers.erase(fd);
+  if (it->second.subscribers.empty()) {
+    this->subscriptions.erase(it);
+  } else {
+    // slows down again when the fastest subscriber left
+    it->second.interval = fastestInterval(it->second);
+  }
+}
+
+// replies are not dropped, so client with full queue is served later
+bool ScopeServer::CanServe(const Client &client) {
+  return !client.requests.empty() && !client.failed &&
+         client.output.size() < MAX_QUEUED_FRAMES;
+}
+
+bool ScopeServer::HasPendingRequests() {
+  return std::any_of(this->clients.begin(),
+                     this->clients.end(),
+                     [](const auto &entry) { return CanServe(entry.second); });
+}
+
+void ScopeServer::ServeNextRequest() {
+  if (this->clients.empty()) {
+    return;
+  }
+
+  // round-robin: first client with pending request after the last served
+  auto it = this->clients.upper_bound(this->last_served_fd);
+  for (size_t i = 0; i < this->clients.size(); i++, it++) {
+    if (it == this->clients.end()) {
+      it = this->clients.begin();
+    }
+    if (CanServe(it->second)) {
+      break;
+    }
+  }
+  if (it == this->clients.end() || !CanServe(it->second)) {
+    return;
+  }
+
+  Client &client = it->second;
+  this->last_served_fd = client.fd;
+  Request request = std::move(client.requests.front());
+  client.requests.pop_front();
+
+  switch (request.type) {
+  case MessageType::Subscribe:
+    Subscribe(client, request);
+    return;
+  case MessageType::Unsubscribe:
+    Unsubscribe(client, request);
+    return;
+  case MessageType::Write:
+  case MessageType::Query:
+  case MessageType::BlockQuery:
+    break;
+  default:
+    Send(client,
+         MessageType::Error,
+         request.id,
+         MakePayload("unknown request type"));
+    return;
+  }
+
+  // same query waiting at the head of other clients shares the round trip
+  std::vector<std::pair<int, uint32_t>> receivers = {{client.fd, request.id}};
+  if (isQuery(request.type)) {
+    for (auto &[fd, other] : this->clients) {
+      if (fd != client.fd && CanServe(other) &&
+          other.requests.front().type == request.type &&
+          other.requests.front().command == request.command) {
+        receivers.emplace_back(fd, other.requests.front().id);
+        other.requests.pop_front();
+      }
+    }
+  }
+
+  bool success = false;
+  Payload payload = Execute(request.type, request.command, success);
+  MessageType reply_type = MessageType::Error;
+  if (success) {
+    reply_type = request.type == MessageType::Write        ? MessageType::Ack
+                 : request.type == MessageType::BlockQuery ? MessageType::Block
+                                                           : MessageType::Reply;
+  }
+  for (auto &[fd, request_id] : receivers) {
+    Send(this->clients[fd], reply_type, request_id, payload);
+  }
+}
+
+void ScopeServer::Subscribe(Client &client, const Request &request) {
+  // payload: "<interval ms> <Q|B> <query>"
+  int interval_ms = 0;
+  char query_type = 0;
+  int command_offset = 0;
+  if (std::sscanf(request.command.c_str(),
+                  "%d %c %n",
+                  &interval_ms,
+                  &query_type,
+                  &command_offset) < 2 ||
+      interval_ms <= 0 ||
+      !isQuery(static_cast<MessageType>(query_type)) ||
+      command_offset == 0) {
+    Send(client,
+         MessageType::Error,
+         request.id,
+         MakePayload("expected \"<interval ms> <Q|B> <query>\""));
+    return;
+  }
+
+  MessageType type = static_cast<MessageType>(query_type);
+  std::string command = request.command.substr(command_offset);
+  Subscription &subscription =
+      this->subscriptions[subscriptionKey(type, command)];
+  if (subscription.subscribers.empty()) {
+    subscription.type = type;
+    subscription.command = command;
+    subscription.next_poll = Clock::now();
+  }
+  subscription.subscribers[client.fd] = {
+      request.id, std::chrono::milliseconds(interval_ms)};
+  subscription.interval = fastestInterval(subscription);
+  // faster subscriber does not wait for the poll planned for slower ones
+  subscription.next_poll =
+      std::min(subscription.next_poll, Clock::now() + subscription.interval);
+
+  // latest result comes with the next poll when the queue is full
+  if (Send(client, MessageType::Ack, request.id, nullptr) &&
+      subscription.latest && client.output.size() < MAX_QUEUED_FRAMES) {
+    Send(client,
+         type == MessageType::BlockQuery ? MessageType::Block
+                                         : MessageType::Reply,
+         request.id,
+         subscription.latest);
+  }
+}
+
+void ScopeServer::Unsubscribe(Client &client, const Request &request) {
+  // payload: "<Q|B> <query>", same query may be subscribed as both types
+  const std::string &payload = request.command;
+  MessageType type = payload.empty() ? MessageType::Error
+                                     : static_cast<MessageType>(payload[0]);
+  if (payload.size() < 3 || payload[1] != ' ' || !isQuery(type)) {
+    Send(client,
+         MessageType::Error,
+         request.id,
+         MakePayload("expected \"<Q|B> <query>\""));
+    return;
+  }
+
+  const std::string key = subscriptionKey(type, payload.substr(2));
+  auto it = this->subscriptions.find(key);
+  if (it == this->subscriptions.end() ||
+      it->second.subscribers.count(client.fd) == 0) {
+    Send(client, MessageType::Error, request.id, MakePayload("not subscribed"));
+    return;
+  }
+  RemoveSubscriber(client.fd, key);
+  Send(client, MessageType::Ack, request.id, nullptr);
+}
+
+void ScopeServer::PollSubscriptions() {
+  const Clock::time_point now = Clock::now();
+  for (auto &[key, subscription] : this->subscriptions) {
+    if (subscription.subscribers.empty() || now < subscription.next_poll) {
+      continue;
+    }
+
+    bool success = false;
+    Payload payload = Execute(subscription.type, subscription.command, success);
+    subscription.next_poll = Clock::now() + subscription.interval;
+    if (!success) {
+      continue;
+    }
+
+    subscription.latest = payload;
+    MessageType type = subscription.type == MessageType::BlockQuery
+                           ? MessageType::Block
+                           : MessageType::Reply;
+    for (auto &[fd, subscriber] : subscription.subscribers) {
+      Client &client = this->clients.at(fd);
+      if (client.output.size() < MAX_QUEUED_FRAMES) {
+        Send(client, type, subscriber.request_id, payload);
+      }
+    }
+  }
+}
+
+int ScopeServer::NextPollTimeoutMs() {
+  int timeout_ms = -1;
+  const Clock::time_point now = Clock::now();
+  for (auto &[key, subscription] : this->subscriptions) {
+    if (subscription.subscribers.empty()) {
+      continue;
+    }
+    int due_ms = std::max<int>(
+        0,
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            subscription.next_poll - now)
+            .count());
+    timeout_ms = timeout_ms < 0 ? due_ms : std::min(timeout_ms, due_ms);
+  }
+  return timeout_ms;
+}
+
+Payload ScopeServer::Execute(MessageType type,
+                             const std::string &command,
+                             bool &success) {
+  success = false;
+  switch (type) {
+  case MessageType::Write:
+    success = this->scope.Write(command);
+    return success ? nullptr : MakePayload("write failed");
+  case MessageType::Query: {
+    std::string reply;
+    if (!this->scope.Query(command, reply)) {
+      return MakePayload("query failed");
+    }
+    // client rejects longer frames, cutting the reply would go unnoticed
+    if (reply.size() > scope_protocol::MAX_PAYLOAD_SIZE) {
+      return MakePayload(fmt::format("reply of {} B exceeds {} B",
+                                     reply.size(),
+                                     scope_protocol::MAX_PAYLOAD_SIZE));
+    }
+    success = true;
+    return MakePayload(reply);
+  }
+  case MessageType::BlockQuery: {
+    // block is read once and handed to all receivers as shared payload
+    auto block = std::make_shared<std::vector<uint8_t>>();
+    if (!this->scope.QueryBlock(command, *block)) {
+      this->scope.Clear();
+      return MakePayload("block query failed");
+    }
+    if (block->size() > scope_protocol::MAX_PAYLOAD_SIZE) {
+      return MakePayload(fmt::format("block of {} B exceeds {} B",
+                                     block->size(),
+                                     scope_protocol::MAX_PAYLOAD_SIZE));
+    }
+    success = true;
+    return block;
+  }
+  default:
+    return MakePayload("unsupported request");
+  }
+}
+
+/**
+ * Queues frame and tries to send it. Returns false when the connection
+ * failed. The client is closed with its subscriptions at the end of the
+ * loop iteration, closing here would invalidate iterators of the callers.
+ */
+bool ScopeServer::Send(Client &client,
+                       MessageType type,
+                       uint32_t request_id,
+                       Payload payload) {
+  if (client.failed) {
+    return false;
+  }
+  scope_protocol::Header header;
+  header.type = type;
+  header.request_id = request_id;
+  header.payload_length = payload ? payload->size() : 0;
+  client.output.push_back({scope_protocol::encodeHeader(header), payload});
+
+  // try immediately, POLLOUT takes over if the socket is full
+  if (!SendToClient(client)) {
+    spdlog::warn(
+        "Sending to client {} failed: {}", client.fd, std::strerror(errno));
+    client.failed = true;
+  }
+  return !client.failed;
+}
+
+Payload ScopeServer::MakePayload(const std::string &text) {
+  return std::make_shared<const std::vector<uint8_t>>(text.begin(),
+                                                      text.end());
+}
+/*
+ *   PRIVATE METHODS END
+ */
+}; // namespace scope_server
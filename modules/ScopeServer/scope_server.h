@@ -0,0 +1,133 @@
+/*********************************************************************
+ * \file   scope_server.h
+ * \brief  Headless daemon sharing one instrument session between local
+ *         clients
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "scope_protocol.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <vector>
+
+namespace scope_server {
+using Clock = std::chrono::steady_clock;
+using Payload = std::shared_ptr<const std::vector<uint8_t>>;
+
+// subscription updates are dropped for clients that do not keep up, their
+// requests wait until the queue has room again
+constexpr size_t MAX_QUEUED_FRAMES = 64;
+// requests of a client are not read further while this many are waiting
+constexpr size_t MAX_QUEUED_REQUESTS = 64;
+
+struct Request {
+  scope_protocol::MessageType type;
+  uint32_t id;
+  std::string command;
+};
+
+struct OutgoingFrame {
+  scope_protocol::HeaderBytes header;
+  Payload payload; // shared between all receivers, never copied
+  size_t offset = 0;
+};
+
+struct Client {
+  int fd = -1;
+  std::vector<uint8_t> input;
+  std::deque<Request> requests;
+  std::deque<OutgoingFrame> output;
+  bool failed = false; // send failed, closed after the loop iteration
+};
+
+struct Subscriber {
+  uint32_t request_id; // of the subscribe request, tags updates
+  std::chrono::milliseconds interval;
+};
+
+struct Subscription {
+  scope_protocol::MessageType type;
+  std::string command;
+  std::chrono::milliseconds interval; // fastest of the subscribers
+  Clock::time_point next_poll;
+  Payload latest;
+  std::map<int, Subscriber> subscribers; // by client fd
+};
+
+/**
+ * Instrument side of the server, replies are complete or the call fails.
+ */
+class Instrument {
+public:
+  virtual ~Instrument() = default;
+
+  virtual bool Write(const std::string &command) = 0;
+  virtual bool Query(const std::string &command, std::string &reply) = 0;
+  virtual bool QueryBlock(const std::string &command,
+                          std::vector<uint8_t> &block) = 0;
+  virtual void Clear() = 0; // after failed transfer
+};
+
+/**
+ * Single threaded poll() loop owning the instrument session. Pending
+ * requests are served round-robin, one per client turn; identical queries
+ * waiting at the head of several clients are answered by one instrument
+ * round trip. Subscriptions poll a query periodically and fan the cached
+ * result out to every subscriber. Replies too long for one frame are sent
+ * as errors.
+ */
+class ScopeServer {
+public:
+  explicit ScopeServer(Instrument &scope);
+  ~ScopeServer();
+
+  bool ListenUnix(const std::string &path);
+  bool ListenTcp(uint16_t port);
+  void Run();
+  void Stop();
+
+private:
+  void AcceptClient();
+  bool ReceiveFromClient(Client &client);
+  bool SplitRequests(Client &client);
+  bool SendToClient(Client &client);
+  void CloseClient(int fd);
+  void CloseFailedClients();
+  void RemoveSubscriber(int fd, const std::string &key);
+
+  static bool CanServe(const Client &client);
+  bool HasPendingRequests();
+  void ServeNextRequest();
+  void Subscribe(Client &client, const Request &request);
+  void Unsubscribe(Client &client, const Request &request);
+  void PollSubscriptions();
+  int NextPollTimeoutMs();
+
+  Payload Execute(scope_protocol::MessageType type,
+                  const std::string &command,
+                  bool &success);
+  bool Send(Client &client,
+            scope_protocol::MessageType type,
+            uint32_t request_id,
+            Payload payload);
+  static Payload MakePayload(const std::string &text);
+
+  Instrument &scope;
+  int listen_fd = -1;
+  std::string unix_path;
+  std::atomic<bool> running{false};
+
+  std::map<int, Client> clients;
+  int last_served_fd = -1;
+  std::map<std::string, Subscription> subscriptions; // by type + command
+};
+}; // namespace scope_server
+
+// SCOPE_SERVER_H
@@ -0,0 +1,150 @@
+/*********************************************************************
+ * \file   ScopeClientTest.cpp
+ * \brief  Unit tests of the ScopeServer protocol framing and ScopeClient
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TestSupport.hpp"
+#include "scope_client.h"
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using scope_protocol::MessageType;
+
+static bool readExactly(int fd, uint8_t *destination, size_t size) {
+  while (size > 0) {
+    ssize_t received = recv(fd, destination, size, 0);
+    if (received <= 0) {
+      return false;
+    }
+    destination += received;
+    size -= received;
+  }
+  return true;
+}
+
+static void sendFrame(int fd,
+                      MessageType type,
+                      uint32_t request_id,
+                      const std::string &payload) {
+  scope_protocol::Header header;
+  header.type = type;
+  header.request_id = request_id;
+  header.payload_length = payload.size();
+  auto bytes = scope_protocol::encodeHeader(header);
+  send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+  send(fd, payload.data(), payload.size(), MSG_NOSIGNAL);
+}
+
+/**
+ * Stands in for ScopeServer: records frames of one client and answers
+ * every request with Ack, or Reply with the request payload for queries.
+ */
+struct FakeServer {
+  std::string path;
+  int listen_fd = -1;
+  std::thread thread;
+  std::vector<scope_protocol::Header> headers;
+  std::vector<std::string> payloads;
+
+  bool Start() {
+    path = "/tmp/ScopeClientTest." + std::to_string(getpid()) + ".sock";
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    unlink(path.c_str());
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 ||
+        bind(listen_fd, (sockaddr *)&address, sizeof(address)) < 0 ||
+        listen(listen_fd, 1) < 0) {
+      return false;
+    }
+    thread = std::thread([this]() { Serve(); });
+    return true;
+  }
+
+  void Serve() {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    uint8_t header_bytes[scope_protocol::HEADER_SIZE];
+    while (fd >= 0 && readExactly(fd, header_bytes, sizeof(header_bytes))) {
+      auto header = scope_protocol::decodeHeader(header_bytes);
+      std::string payload(header.payload_length, '\0');
+      if (!readExactly(fd, (uint8_t *)payload.data(), payload.size())) {
+        break;
+      }
+      headers.push_back(header);
+      payloads.push_back(payload);
+      if (header.type == MessageType::Query) {
+        sendFrame(fd, MessageType::Reply, header.request_id, payload);
+      } else {
+        sendFrame(fd, MessageType::Ack, header.request_id, "");
+      }
+    }
+    close(fd);
+  }
+
+  void Join() {
+    thread.join();
+    close(listen_fd);
+    unlink(path.c_str());
+  }
+};
+
+static void testHeaderRoundTrip() {
+  scope_protocol::Header header;
+  header.payload_length = 0x01020304;
+  header.type = MessageType::BlockQuery;
+  header.request_id = 0xA0B0C0D0;
+  auto bytes = scope_protocol::encodeHeader(header);
+  // lengths and ids are big endian
+  CHECK(bytes[0] == 0x01 && bytes[3] == 0x04);
+  CHECK(bytes[4] == 'B');
+  CHECK(bytes[5] == 0xA0 && bytes[8] == 0xD0);
+
+  auto decoded = scope_protocol::decodeHeader(bytes.data());
+  CHECK(decoded.payload_length == header.payload_length);
+  CHECK(decoded.type == header.type);
+  CHECK(decoded.request_id == header.request_id);
+}
+
+// unsubscribe names the subscription type, query may be subscribed as both
+static void testSubscriptionFrames() {
+  FakeServer server;
+  CHECK(server.Start());
+  {
+    scope_client::ScopeClient client;
+    CHECK(client.ConnectUnix(server.path));
+    uint32_t subscription_id = 0;
+    CHECK(client.Subscribe(":MEAS:VRMS?", 100, false, subscription_id));
+    CHECK(client.Subscribe(":WAV:DATA?", 250, true, subscription_id));
+    CHECK(client.Unsubscribe(":WAV:DATA?", true));
+    std::string reply;
+    CHECK(client.Query("*IDN?", reply));
+    CHECK(reply == "*IDN?");
+  }
+  server.Join();
+
+  CHECK(server.headers.size() == 4);
+  if (server.headers.size() != 4) {
+    return;
+  }
+  CHECK(server.headers[0].type == MessageType::Subscribe);
+  CHECK(server.payloads[0] == "100 Q :MEAS:VRMS?");
+  CHECK(server.payloads[1] == "250 B :WAV:DATA?");
+  CHECK(server.headers[2].type == MessageType::Unsubscribe);
+  CHECK(server.payloads[2] == "B :WAV:DATA?");
+  // every request has its own id, replies are matched by it
+  CHECK(server.headers[0].request_id != server.headers[1].request_id);
+  CHECK(server.headers[3].type == MessageType::Query);
+}
+
+int main() {
+  testHeaderRoundTrip();
+  testSubscriptionFrames();
+  return TestSupport::Result();
+}
@@ -0,0 +1,385 @@
+/*********************************************************************
+ * \file   ScopeServerTest.cpp
+ * \brief  Unit tests of ScopeServer request scheduling, subscriptions
+ *         and queue limits
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "TestSupport.hpp"
+#include "scope_server.h"
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using scope_protocol::MessageType;
+using namespace std::chrono_literals;
+
+/**
+ * Records executed commands. Replies are set per command, "*GATE?" blocks
+ * until Release so tests can queue requests while the server is busy.
+ */
+class FakeInstrument : public scope_server::Instrument {
+public:
+  bool Write(const std::string &command) override {
+    Record(command);
+    return true;
+  }
+
+  bool Query(const std::string &command, std::string &reply) override {
+    Record(command);
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (command == "*GATE?") {
+      this->gate_entered = true;
+      this->condition.notify_all();
+      this->condition.wait(lock, [this]() { return this->gate_open; });
+    }
+    auto found = this->replies.find(command);
+    reply = found != this->replies.end() ? found->second : command;
+    return true;
+  }
+
+  bool QueryBlock(const std::string &command,
+                  std::vector<uint8_t> &block) override {
+    const size_t calls = Record(command);
+    block.assign(this->block_size, 0x0A);
+    return this->block_calls_limit == 0 || calls <= this->block_calls_limit;
+  }
+
+  void Clear() override {}
+
+  void WaitForGate() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->condition.wait(lock, [this]() { return this->gate_entered; });
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->gate_open = true;
+    this->condition.notify_all();
+  }
+
+  std::vector<std::string> Commands() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->commands;
+  }
+
+  size_t Count(const std::string &command) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return std::count(this->commands.begin(), this->commands.end(), command);
+  }
+
+  std::map<std::string, std::string> replies; // set before the server runs
+  size_t block_size = 16;
+  size_t block_calls_limit = 0; // block queries fail after, 0 never
+
+private:
+  size_t Record(const std::string &command) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->commands.push_back(command);
+    return std::count(this->commands.begin(), this->commands.end(), command);
+  }
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<std::string> commands;
+  bool gate_entered = false;
+  bool gate_open = false;
+};
+
+struct Frame {
+  scope_protocol::Header header;
+  std::string payload;
+};
+
+static bool readExactly(int fd, uint8_t *destination, size_t size) {
+  while (size > 0) {
+    ssize_t received = recv(fd, destination, size, 0);
+    if (received <= 0) {
+      return false;
+    }
+    destination += received;
+    size -= received;
+  }
+  return true;
+}
+
+static void sendFrame(int fd,
+                      MessageType type,
+                      uint32_t request_id,
+                      const std::string &payload) {
+  scope_protocol::Header header;
+  header.type = type;
+  header.request_id = request_id;
+  header.payload_length = payload.size();
+  auto bytes = scope_protocol::encodeHeader(header);
+  send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+  send(fd, payload.data(), payload.size(), MSG_NOSIGNAL);
+}
+
+// false when nothing arrives within timeout
+static bool receiveFrame(int fd,
+                         Frame &frame,
+                         std::chrono::milliseconds timeout = 2000ms) {
+  pollfd poll_fd = {fd, POLLIN, 0};
+  uint8_t header_bytes[scope_protocol::HEADER_SIZE];
+  if (poll(&poll_fd, 1, timeout.count()) <= 0 ||
+      !readExactly(fd, header_bytes, sizeof(header_bytes))) {
+    return false;
+  }
+  frame.header = scope_protocol::decodeHeader(header_bytes);
+  frame.payload.assign(frame.header.payload_length, '\0');
+  return readExactly(fd, (uint8_t *)frame.payload.data(), frame.payload.size());
+}
+
+/**
+ * Server on a unix socket running in its own thread.
+ */
+struct TestServer {
+  FakeInstrument instrument;
+  scope_server::ScopeServer server{instrument};
+  std::string path;
+  std::thread thread;
+  std::vector<int> client_fds;
+
+  bool Start() {
+    path = "/tmp/ScopeServerTest." + std::to_string(getpid()) + ".sock";
+    if (!server.ListenUnix(path)) {
+      return false;
+    }
+    thread = std::thread([this]() { server.Run(); });
+    return true;
+  }
+
+  int OpenSocket() {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, (sockaddr *)&address, sizeof(address)) < 0) {
+      close(fd);
+      return -1;
+    }
+    client_fds.push_back(fd);
+    return fd;
+  }
+
+  // connection is accepted once the server answers a write
+  int Connect() {
+    int fd = OpenSocket();
+    if (fd < 0) {
+      return -1;
+    }
+    sendFrame(fd, MessageType::Write, 0, ":CONNect");
+    Frame ack;
+    return receiveFrame(fd, ack) && ack.header.type == MessageType::Ack ? fd
+                                                                        : -1;
+  }
+
+  // queries sent after this wait until Release
+  void Hold(int fd) {
+    sendFrame(fd, MessageType::Query, 0, "*GATE?");
+    instrument.WaitForGate();
+  }
+
+  ~TestServer() {
+    instrument.Release();
+    server.Stop();
+    if (thread.joinable()) {
+      // wakes poll() up so the loop sees the stop flag
+      OpenSocket();
+      thread.join();
+    }
+    for (int fd : client_fds) {
+      close(fd);
+    }
+  }
+};
+
+// same query at the head of several clients is executed once
+static void testBatching() {
+  TestServer test;
+  test.instrument.replies[":MEASure:VRMS?"] = "7.07E-1";
+  CHECK(test.Start());
+  int first = test.Connect();
+  int second = test.Connect();
+  int third = test.Connect();
+
+  test.Hold(third);
+  sendFrame(first, MessageType::Query, 11, ":MEASure:VRMS?");
+  sendFrame(second, MessageType::Query, 22, ":MEASure:VRMS?");
+  // only heads of the queues are shared
+  sendFrame(second, MessageType::Query, 23, ":MEASure:VRMS?");
+  test.instrument.Release();
+
+  Frame frame;
+  CHECK(receiveFrame(first, frame));
+  CHECK(frame.header.type == MessageType::Reply &&
+        frame.header.request_id == 11 && frame.payload == "7.07E-1");
+  CHECK(receiveFrame(second, frame));
+  CHECK(frame.header.request_id == 22 && frame.payload == "7.07E-1");
+  CHECK(receiveFrame(second, frame));
+  CHECK(frame.header.request_id == 23);
+  CHECK(test.instrument.Count(":MEASure:VRMS?") == 2);
+}
+
+// one request per client turn, busy client does not delay the others
+static void testRoundRobin() {
+  TestServer test;
+  CHECK(test.Start());
+  int first = test.Connect();
+  int second = test.Connect();
+  int third = test.Connect();
+
+  test.Hold(third);
+  for (const char *command : {":A1", ":A2", ":A3", ":A4"}) {
+    sendFrame(first, MessageType::Write, 1, command);
+  }
+  for (const char *command : {":B1", ":B2"}) {
+    sendFrame(second, MessageType::Write, 2, command);
+  }
+  test.instrument.Release();
+
+  Frame frame;
+  for (int i = 0; i < 4; i++) {
+    CHECK(receiveFrame(first, frame));
+  }
+  std::vector<std::string> commands = test.instrument.Commands();
+  commands.erase(commands.begin(), commands.begin() + 4); // connect, gate
+  CHECK((commands == std::vector<std::string>{
+                         ":A1", ":B1", ":A2", ":B2", ":A3", ":A4"}));
+}
+
+// shared poll at the fastest interval, updates tagged per subscriber
+static void testSubscriptions() {
+  TestServer test;
+  CHECK(test.Start());
+  int fast = test.Connect();
+  int slow = test.Connect();
+
+  sendFrame(slow, MessageType::Subscribe, 5, "200 Q :MEASure:FREQuency?");
+  Frame frame;
+  CHECK(receiveFrame(slow, frame) && frame.header.type == MessageType::Ack);
+  sendFrame(fast, MessageType::Subscribe, 7, "20 Q :MEASure:FREQuency?");
+  CHECK(receiveFrame(fast, frame) && frame.header.type == MessageType::Ack);
+  // latest result is sent right away to a new subscriber
+  CHECK(receiveFrame(fast, frame) && frame.header.request_id == 7 &&
+        frame.header.type == MessageType::Reply);
+
+  std::this_thread::sleep_for(400ms);
+  const size_t polls = test.instrument.Count(":MEASure:FREQuency?");
+  CHECK(polls >= 8 && polls <= 25);
+  // every poll goes to both subscribers with their request ids
+  size_t fast_updates = 0;
+  while (receiveFrame(fast, frame, 0ms)) {
+    CHECK(frame.header.request_id == 7);
+    fast_updates++;
+  }
+  size_t slow_updates = 0;
+  while (receiveFrame(slow, frame, 0ms)) {
+    CHECK(frame.header.request_id == 5);
+    slow_updates++;
+  }
+  CHECK(slow_updates >= polls - 1 && fast_updates >= polls - 2);
+
+  // poll slows down again when the fast subscriber leaves
+  sendFrame(fast, MessageType::Unsubscribe, 8, "Q :MEASure:FREQuency?");
+  while (receiveFrame(fast, frame) && frame.header.request_id != 8) {
+  }
+  CHECK(frame.header.type == MessageType::Ack);
+  const size_t before = test.instrument.Count(":MEASure:FREQuency?");
+  std::this_thread::sleep_for(500ms);
+  const size_t after = test.instrument.Count(":MEASure:FREQuency?");
+  CHECK(after - before >= 1 && after - before <= 4);
+  CHECK(!receiveFrame(fast, frame, 0ms));
+}
+
+// updates for a client not reading are dropped above MAX_QUEUED_FRAMES
+static void testSubscriptionDropping() {
+  TestServer test;
+  // larger than the socket buffer, queued frames stay in the server
+  test.instrument.block_size = 1024 * 1024;
+  test.instrument.block_calls_limit = 200;
+  CHECK(test.Start());
+  int reader = test.Connect();
+
+  sendFrame(reader, MessageType::Subscribe, 3, "1 B :WAVeform:DATA?");
+  for (int i = 0; i < 200 && test.instrument.Count(":WAVeform:DATA?") < 200;
+       i++) {
+    std::this_thread::sleep_for(10ms);
+  }
+  CHECK(test.instrument.Count(":WAVeform:DATA?") >= 200);
+
+  Frame frame;
+  size_t updates = 0;
+  while (receiveFrame(reader, frame, 500ms)) {
+    if (frame.header.type == MessageType::Block) {
+      CHECK(frame.payload.size() == test.instrument.block_size);
+      updates++;
+    }
+  }
+  CHECK(updates > 0 && updates <= scope_server::MAX_QUEUED_FRAMES);
+}
+
+// replies are never dropped, the client is served when it reads again
+static void testReplyBackpressure() {
+  TestServer test;
+  test.instrument.replies[":BIG?"] = std::string(512 * 1024, 'x');
+  CHECK(test.Start());
+  int reader = test.Connect();
+  int other = test.Connect();
+
+  constexpr uint32_t requests = 3 * scope_server::MAX_QUEUED_FRAMES;
+  for (uint32_t id = 1; id <= requests; id++) {
+    sendFrame(reader, MessageType::Query, id, ":BIG?");
+  }
+  std::this_thread::sleep_for(200ms);
+  CHECK(test.instrument.Count(":BIG?") <= scope_server::MAX_QUEUED_FRAMES + 1);
+
+  // others are still served while the queue is full
+  sendFrame(other, MessageType::Query, 9, "*IDN?");
+  Frame frame;
+  CHECK(receiveFrame(other, frame) && frame.payload == "*IDN?");
+
+  uint32_t expected_id = 1;
+  while (expected_id <= requests && receiveFrame(reader, frame)) {
+    CHECK(frame.header.request_id == expected_id);
+    expected_id++;
+  }
+  CHECK(expected_id == requests + 1);
+}
+
+// reply too long for a frame is an error instead of a cut reply
+static void testOversizedReply() {
+  TestServer test;
+  test.instrument.replies[":HUGE?"] =
+      std::string(scope_protocol::MAX_PAYLOAD_SIZE + 1, 'x');
+  CHECK(test.Start());
+  int client = test.Connect();
+
+  sendFrame(client, MessageType::Query, 4, ":HUGE?");
+  Frame frame;
+  CHECK(receiveFrame(client, frame));
+  CHECK(frame.header.type == MessageType::Error &&
+        frame.header.request_id == 4);
+  CHECK(frame.payload.find("exceeds") != std::string::npos);
+}
+
+int main() {
+  spdlog::set_level(spdlog::level::warn);
+  testBatching();
+  testRoundRobin();
+  testSubscriptions();
+  testSubscriptionDropping();
+  testReplyBackpressure();
+  testOversizedReply();
+  return TestSupport::Result();
+}
@@ -0,0 +1,46 @@
+/*********************************************************************
+ * \file   TestSupport.hpp
+ * \brief  Minimal checks for module unit tests run by CTest
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+namespace TestSupport {
+inline int failures = 0;
+
+inline void Fail(const char *file, int line, const char *expression) {
+  std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+  failures++;
+}
+
+// exit code of test executable, non zero when any check failed
+inline int Result() {
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+  }
+  return failures > 0 ? 1 : 0;
+}
+} // namespace TestSupport
+
+#define CHECK(condition)                                                     \
+  do {                                                                       \
+    if (!(condition)) {                                                      \
+      TestSupport::Fail(__FILE__, __LINE__, #condition);                     \
+    }                                                                        \
+  } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                              \
+  do {                                                                       \
+    if (!(std::abs((double)(actual) - (double)(expected)) <=                 \
+          (double)(tolerance))) {                                            \
+      TestSupport::Fail(__FILE__, __LINE__, #actual " ~ " #expected);        \
+      std::fprintf(stderr,                                                   \
+                   "  actual %.9g, expected %.9g\n",                         \
+                   (double)(actual),                                         \
+                   (double)(expected));                                      \
+    }                                                                        \
+  } while (0)
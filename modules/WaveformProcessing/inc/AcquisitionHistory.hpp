@@ -0,0 +1,85 @@
+/*********************************************************************
+ * \file   AcquisitionHistory.hpp
+ * \brief  Bounded in-memory history of acquired waveform records with
+ *         search over their summary statistics
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "WaveformRecord.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace WaveformProcessing {
+struct HistoryRecord {
+  uint64_t id = 0;
+  RecordMetadata metadata;
+  RecordStats stats;
+  const uint8_t *samples = nullptr; // valid until record is evicted
+  size_t bytes = 0;
+};
+
+/**
+ * Samples live in one preallocated arena used as a ring; metadata and
+ * statistics in fixed size slot arrays, so memory use does not grow during
+ * long runs. Oldest records are evicted when arena or slots run out.
+ *
+ * Statistics are stored column-wise with per block min/max (zone map), a
+ * range search only scans blocks whose range overlaps the query.
+ */
+class AcquisitionHistory {
+public:
+  AcquisitionHistory(size_t capacity_bytes, size_t max_records);
+
+  uint64_t Append(const RecordMetadata &metadata,
+                  const uint8_t *samples,
+                  size_t bytes);
+  bool Get(uint64_t id, HistoryRecord &record) const;
+  void Clear();
+
+  size_t Size() const;
+  uint64_t FirstId() const;
+  uint64_t LastId() const;
+  size_t CapacityBytes() const;
+
+  std::vector<uint64_t>
+  FindInRange(Stat stat,
+              float low,
+              float high = std::numeric_limits<float>::infinity(),
+              size_t max_results = 1000) const;
+  std::vector<uint64_t>
+  FindOutliers(Stat stat, float sigmas, size_t max_results = 1000) const;
+
+private:
+  struct Slot {
+    uint64_t id = 0;
+    size_t offset = 0;
+    size_t bytes = 0;
+    RecordMetadata metadata;
+  };
+
+  static constexpr size_t BLOCK_SIZE = 256; // slots per zone map entry
+
+  void EvictOldest();
+  bool Overlaps(const Slot &slot, size_t offset, size_t bytes) const;
+  size_t SlotIndex(uint64_t id) const;
+  void ScanRange(Stat stat,
+                 float low,
+                 float high,
+                 std::vector<uint64_t> &ids) const;
+
+  std::vector<uint8_t> arena;
+  size_t write_offset = 0;
+
+  std::vector<Slot> slots;
+  std::array<std::vector<float>, STAT_COUNT> stat_columns;
+  std::array<std::vector<float>, STAT_COUNT> block_min;
+  std::array<std::vector<float>, STAT_COUNT> block_max;
+
+  uint64_t first_id = 1; // oldest record kept
+  uint64_t next_id = 1;
+};
+} // namespace WaveformProcessing
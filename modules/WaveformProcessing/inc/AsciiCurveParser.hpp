@@ -0,0 +1,50 @@
+/*********************************************************************
+ * \file   AsciiCurveParser.hpp
+ * \brief  Bulk parser of comma separated ASCII waveform replies
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace WaveformProcessing {
+/**
+ * Parses replies like ":CURVE 12,-3,45\n" or "-1.2e-3,4.5e-3" into a
+ * caller owned buffer. Command header, IEEE 488.2 block header and
+ * terminator are skipped.
+ *
+ * Delimiters are located 16 bytes at a time with SSE2 where available and
+ * each field is converted with std::from_chars. Large replies are split at
+ * delimiters into ranges parsed by several threads: commas are counted
+ * first, so every range knows where its values start in the output.
+ */
+class AsciiCurveParser {
+public:
+  explicit AsciiCurveParser(unsigned threads = 0); // 0 - one per core
+
+  size_t CountValues(std::string_view reply) const;
+  bool Parse(std::string_view reply,
+             int16_t *samples,
+             size_t capacity,
+             size_t &count) const;
+  bool Parse(std::string_view reply,
+             float *samples,
+             size_t capacity,
+             size_t &count) const;
+
+private:
+  template <typename T>
+  bool ParseValues(std::string_view reply,
+                   T *samples,
+                   size_t capacity,
+                   size_t &count) const;
+  std::string_view Payload(std::string_view reply) const;
+  std::vector<std::string_view> Split(std::string_view payload) const;
+
+  unsigned threads;
+};
+} // namespace WaveformProcessing
@@ -0,0 +1,94 @@
+/*********************************************************************
+ * \file   FftPlan.hpp
+ * \brief  Mixed-radix FFT of real records with precomputed twiddles
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace WaveformProcessing {
+/**
+ * Buffers used by one transform. Kept by the caller and reused between
+ * records, so repeated transforms of the same length do not allocate.
+ */
+struct FftWorkspace {
+  std::vector<float> re;
+  std::vector<float> im;
+  std::vector<float> work_re;
+  std::vector<float> work_im;
+  std::vector<float> bin_re; // transform result, Length()/2 + 1 bins
+  std::vector<float> bin_im;
+  std::vector<float> chirp_re; // Bluestein convolution, large primes only
+  std::vector<float> chirp_im;
+  std::vector<float> chirp_work_re;
+  std::vector<float> chirp_work_im;
+};
+
+/**
+ * Forward FFT of real input of even length N. Input is packed into N/2
+ * complex points transformed with Stockham autosort stages of radix 4, 2,
+ * 3 and 5 (other small prime factors use a direct DFT stage), then split
+ * into the N/2 + 1 bins of the real spectrum. When N/2 has a prime factor
+ * above MAX_DIRECT_RADIX, the complex transform is done with Bluestein's
+ * chirp-z algorithm as a convolution of 2/3/5-smooth length, so any
+ * length costs O(N log N).
+ *
+ * Data is kept as separate real and imaginary arrays and the innermost
+ * loop of every stage walks contiguous memory with a constant twiddle,
+ * which the compiler turns into SIMD code.
+ *
+ * Plans are immutable, Get() caches them per length and may be called from
+ * several threads.
+ */
+constexpr size_t MAX_DIRECT_RADIX = 31;
+
+class FftPlan {
+public:
+  explicit FftPlan(size_t length);
+
+  static std::shared_ptr<const FftPlan> Get(size_t length);
+
+  size_t Length() const;
+  size_t BinCount() const;
+  void Transform(const float *input, FftWorkspace &workspace) const;
+
+private:
+  struct Stage {
+    size_t radix;
+    size_t stride; // product of radices of previous stages
+    size_t span;   // butterflies per stride, N / (2 * stride * radix)
+    std::vector<float> twiddle_re; // span x (radix - 1)
+    std::vector<float> twiddle_im;
+    std::vector<float> root_re; // radix x radix, direct DFT stages only
+    std::vector<float> root_im;
+  };
+
+  void PrepareChirp();
+  void RunStages(float *&x_re,
+                 float *&x_im,
+                 float *&y_re,
+                 float *&y_im) const;
+  void RunChirp(float *x_re, float *x_im, FftWorkspace &workspace) const;
+  void RunStage(const Stage &stage,
+                const float *x_re,
+                const float *x_im,
+                float *y_re,
+                float *y_im) const;
+
+  size_t length;
+  size_t half; // complex points transformed
+  std::vector<Stage> stages;
+  std::vector<float> split_re; // e^(-2 pi i k / N), k < N / 4 + 1
+  std::vector<float> split_im;
+  // Bluestein: complex stages of the convolution length in chirp->stages
+  std::shared_ptr<const FftPlan> chirp;
+  std::vector<float> chirp_w_re; // e^(-pi i k^2 / half), k < half
+  std::vector<float> chirp_w_im;
+  std::vector<float> chirp_b_re; // transform of conj(w), divided by length
+  std::vector<float> chirp_b_im;
+};
+} // namespace WaveformProcessing
@@ -0,0 +1,76 @@
+/*********************************************************************
+ * \file   FirFilter.hpp
+ * \brief  Streaming FIR filtering and decimation of acquired records
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "WaveformRecord.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WaveformProcessing {
+enum class FilterType { LowPass, BandPass };
+
+struct FilterSettings {
+  FilterType type = FilterType::LowPass;
+  double low_cutoff = 0.0;  // Hz, lower band edge of band-pass
+  double high_cutoff = 0.0; // Hz, 0 - 0.8 of Nyquist after decimation
+  size_t taps = 63;         // rounded up to odd, linear phase
+  size_t decimation = 1;    // keep every n-th filtered sample
+};
+
+/**
+ * Windowed-sinc (Blackman) FIR filter followed by decimation. Only the
+ * kept output samples are computed, which costs taps / decimation
+ * multiplies per input sample like a polyphase decimator. Each output is
+ * a dot product of the coefficients with a contiguous window of input,
+ * computed 8 floats at a time with SSE2 where available.
+ *
+ * The last taps - 1 input samples and the decimation phase are kept
+ * between calls, so consecutive records are filtered as one stream.
+ * Coefficients are designed once per sample rate.
+ */
+class FirFilter {
+public:
+  FirFilter(const FilterSettings &settings = FilterSettings());
+
+  void SetSettings(const FilterSettings &settings);
+  const FilterSettings &GetSettings() const;
+  const std::vector<float> &GetCoefficients() const;
+
+  // designs coefficients for sample rate in Hz and resets the stream
+  bool Design(double sample_rate);
+  // starts a new stream, next input is not continued from previous ones
+  void Reset();
+
+  size_t OutputCount(size_t input_count) const;
+  size_t Process(const float *input, size_t count, float *output);
+  size_t Process(const int16_t *input, size_t count, float *output);
+  /**
+   * Filters record as continuation of the previous one, redesigning when
+   * sample rate changed. Filtered record has signed 16 bit samples with
+   * scaling of the filtered volts, so it is decoded like acquired ones.
+   */
+  bool ProcessRecord(const uint8_t *samples,
+                     const RecordMetadata &metadata,
+                     RecordMetadata &filtered_metadata,
+                     std::vector<uint8_t> &filtered);
+
+private:
+  template <typename Sample>
+  size_t Filter(const Sample *input, size_t count, float *output);
+
+  FilterSettings settings;
+  double sample_rate = 0.0;
+  std::vector<float> coefficients; // reversed, dot product runs forward
+  double dc_gain = 0.0;
+  std::vector<float> window; // taps - 1 previous inputs, then the block
+  size_t skip = 0;           // inputs before the next kept output
+  bool primed = false;       // history filled with the first input
+  std::vector<int16_t> codes;
+  std::vector<float> output;
+};
+} // namespace WaveformProcessing
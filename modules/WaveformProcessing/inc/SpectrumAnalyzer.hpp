@@ -0,0 +1,84 @@
+/*********************************************************************
+ * \file   SpectrumAnalyzer.hpp
+ * \brief  Averaged power spectra and harmonic distortion of acquired
+ *         records
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include "FftPlan.hpp"
+#include "WaveformRecord.hpp"
+#include <map>
+
+namespace WaveformProcessing {
+enum class WindowType { Hann, Blackman, FlatTop };
+
+struct SpectrumSettings {
+  WindowType window = WindowType::Hann;
+  size_t segment_length = 0; // samples per FFT, 0 - whole record
+  double overlap = 0.5;      // fraction of segment shared with the next one
+  int harmonics = 10;        // highest harmonic included in THD
+};
+
+struct SpectrumInput {
+  RecordMetadata metadata;
+  const uint8_t *samples = nullptr;
+};
+
+struct Spectrum {
+  int channel = 1;
+  // one-sided, V^2 (rms) of a sine centred in the bin
+  std::vector<float> power;
+  double bin_width = 0.0; // Hz
+  size_t averages = 0;
+  double dominant_frequency = 0.0;
+  double dominant_rms = 0.0;
+  double thd = 0.0; // rms of harmonics relative to fundamental
+  double snr_db = 0.0;
+};
+
+/**
+ * Welch averaged spectra: record is split into overlapping windowed
+ * segments whose power spectra are averaged. Dominant tone, harmonics and
+ * noise are measured by summing bins of window main lobes.
+ *
+ * Window tables and FFT workspaces are kept between calls, so continuous
+ * analysis of records of the same length does not allocate. Records of
+ * different channels are processed in parallel.
+ */
+class SpectrumAnalyzer {
+public:
+  SpectrumAnalyzer(const SpectrumSettings &settings = SpectrumSettings());
+
+  void SetSettings(const SpectrumSettings &settings);
+  const SpectrumSettings &GetSettings() const;
+
+  std::vector<Spectrum> Analyze(const std::vector<SpectrumInput> &inputs);
+
+private:
+  struct WindowTable {
+    std::vector<float> coefficients;
+    double coherent_gain = 0.0; // sum of coefficients
+    double noise_bins = 0.0;    // equivalent noise bandwidth in bins
+  };
+
+  struct ChannelWorkspace {
+    std::vector<float> volts;
+    std::vector<float> segment;
+    FftWorkspace fft;
+  };
+
+  size_t SegmentLength(size_t record_length) const;
+  const WindowTable &PrepareWindow(size_t length);
+  void AnalyzeChannel(const SpectrumInput &input,
+                      const WindowTable &window,
+                      ChannelWorkspace &workspace,
+                      Spectrum &spectrum) const;
+  void MeasureTones(Spectrum &spectrum, const WindowTable &window) const;
+
+  SpectrumSettings settings;
+  std::map<size_t, WindowTable> windows; // by segment length
+  std::vector<ChannelWorkspace> workspaces;
+};
+} // namespace WaveformProcessing
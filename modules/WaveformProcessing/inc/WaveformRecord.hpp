@@ -0,0 +1,61 @@
+/*********************************************************************
+ * \file   WaveformRecord.hpp
+ * \brief  Acquired waveform description, sample decoding and summary
+ *         statistics
+ *
+ * \date   October 2026
+ *********************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WaveformProcessing {
+/**
+ * Conversion of raw sample codes to physical units, as reported by the
+ * instrument waveform preamble:
+ *   volts = (code - y_reference) * y_increment + y_origin
+ */
+struct WaveformScaling {
+  double x_increment = 1.0; // seconds between samples
+  double y_increment = 1.0;
+  double y_origin = 0.0;
+  double y_reference = 0.0;
+};
+
+struct RecordMetadata {
+  std::chrono::system_clock::time_point timestamp;
+  int channel = 1;
+  double vertical_scale = 0.0;  // V/div set by channels.scale.vertical
+  double vertical_offset = 0.0; // V set by channels.offset.vertical
+  WaveformScaling scaling;
+  int sample_width = 1; // bytes per sample, big endian
+  bool signed_samples = false;
+  uint32_t sample_count = 0;
+};
+
+enum class Stat { Min, Max, Vpp, Mean, Rms, Frequency };
+constexpr size_t STAT_COUNT = 6;
+
+struct RecordStats {
+  float values[STAT_COUNT] = {0};
+
+  float &operator[](Stat stat) {
+    return values[static_cast<size_t>(stat)];
+  }
+  float operator[](Stat stat) const {
+    return values[static_cast<size_t>(stat)];
+  }
+};
+
+int32_t sampleCode(const uint8_t *samples,
+                   size_t index,
+                   const RecordMetadata &metadata);
+void decodeVolts(const uint8_t *samples,
+                 const RecordMetadata &metadata,
+                 std::vector<float> &volts);
+RecordStats computeStats(const uint8_t *samples,
+                         const RecordMetadata &metadata);
+} // namespace WaveformProcessing
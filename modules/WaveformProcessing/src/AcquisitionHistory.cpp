@@ -0,0 +1,242 @@
+/*********************************************************************
+ * \file   AcquisitionHistory.cpp
+ * \brief  Definition of AcquisitionHistory class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "AcquisitionHistory.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace WaveformProcessing {
+constexpr float NO_MIN = std::numeric_limits<float>::infinity();
+constexpr float NO_MAX = -std::numeric_limits<float>::infinity();
+
+AcquisitionHistory::AcquisitionHistory(size_t capacity_bytes,
+                                       size_t max_records)
+    : arena(capacity_bytes), slots(std::max<size_t>(max_records, 1)) {
+  const size_t block_count = (slots.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  for (size_t stat = 0; stat < STAT_COUNT; stat++) {
+    this->stat_columns[stat].assign(slots.size(), 0.0f);
+    this->block_min[stat].assign(block_count, NO_MIN);
+    this->block_max[stat].assign(block_count, NO_MAX);
+  }
+}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+uint64_t AcquisitionHistory::Append(const RecordMetadata &metadata,
+                                    const uint8_t *samples,
+                                    size_t bytes) {
+  if (bytes > this->arena.size() ||
+      bytes < (size_t)metadata.sample_count * metadata.sample_width) {
+    spdlog::error("Record of {} B does not fit history of {} B",
+                  bytes,
+                  this->arena.size());
+    return 0;
+  }
+
+  if (Size() == this->slots.size()) {
+    EvictOldest();
+  }
+  // records between write offset and arena end are the oldest ones, they
+  // go first when writing wraps around
+  if (this->write_offset + bytes > this->arena.size()) {
+    while (Size() > 0 &&
+           this->slots[SlotIndex(this->first_id)].offset >=
+               this->write_offset) {
+      EvictOldest();
+    }
+    this->write_offset = 0;
+  }
+  while (Size() > 0 && Overlaps(this->slots[SlotIndex(this->first_id)],
+                                this->write_offset,
+                                bytes)) {
+    EvictOldest();
+  }
+
+  const uint64_t id = this->next_id++;
+  const size_t index = SlotIndex(id);
+  Slot &slot = this->slots[index];
+  slot.id = id;
+  slot.offset = this->write_offset;
+  slot.bytes = bytes;
+  slot.metadata = metadata;
+  std::memcpy(this->arena.data() + this->write_offset, samples, bytes);
+  this->write_offset += bytes;
+
+  RecordStats stats = computeStats(samples, metadata);
+  const size_t block = index / BLOCK_SIZE;
+  const size_t block_begin = block * BLOCK_SIZE;
+  const size_t block_end = std::min(block_begin + BLOCK_SIZE, slots.size());
+  for (size_t stat = 0; stat < STAT_COUNT; stat++) {
+    this->stat_columns[stat][index] = stats.values[stat];
+
+    // rebuild zone of the block from records still kept in it
+    float minimum = NO_MIN;
+    float maximum = NO_MAX;
+    for (size_t i = block_begin; i < block_end; i++) {
+      if (this->slots[i].id >= this->first_id) {
+        minimum = std::min(minimum, this->stat_columns[stat][i]);
+        maximum = std::max(maximum, this->stat_columns[stat][i]);
+      }
+    }
+    this->block_min[stat][block] = minimum;
+    this->block_max[stat][block] = maximum;
+  }
+
+  return id;
+}
+
+bool AcquisitionHistory::Get(uint64_t id, HistoryRecord &record) const {
+  if (id < this->first_id || id >= this->next_id) {
+    return false;
+  }
+
+  const size_t index = SlotIndex(id);
+  const Slot &slot = this->slots[index];
+  record.id = id;
+  record.metadata = slot.metadata;
+  for (size_t stat = 0; stat < STAT_COUNT; stat++) {
+    record.stats.values[stat] = this->stat_columns[stat][index];
+  }
+  record.samples = this->arena.data() + slot.offset;
+  record.bytes = slot.bytes;
+  return true;
+}
+
+void AcquisitionHistory::Clear() {
+  this->first_id = this->next_id;
+  this->write_offset = 0;
+  for (size_t stat = 0; stat < STAT_COUNT; stat++) {
+    std::fill(
+        this->block_min[stat].begin(), this->block_min[stat].end(), NO_MIN);
+    std::fill(
+        this->block_max[stat].begin(), this->block_max[stat].end(), NO_MAX);
+  }
+}
+
+size_t AcquisitionHistory::Size() const {
+  return this->next_id - this->first_id;
+}
+
+uint64_t AcquisitionHistory::FirstId() const {
+  return this->first_id;
+}
+
+uint64_t AcquisitionHistory::LastId() const {
+  return this->next_id - 1;
+}
+
+size_t AcquisitionHistory::CapacityBytes() const {
+  return this->arena.size();
+}
+
+/**
+ * Returns ids of records with stat value in [low, high], oldest first.
+ * If more match, the most recent max_results are returned.
+ */
+std::vector<uint64_t> AcquisitionHistory::FindInRange(
+    Stat stat, float low, float high, size_t max_results) const {
+  std::vector<uint64_t> ids;
+  ScanRange(stat, low, high, ids);
+  std::sort(ids.begin(), ids.end());
+  if (ids.size() > max_results) {
+    ids.erase(ids.begin(), ids.end() - max_results);
+  }
+  return ids;
+}
+
+/**
+ * Returns ids of records whose stat differs from the mean of all kept
+ * records by more than sigmas standard deviations.
+ */
+std::vector<uint64_t> AcquisitionHistory::FindOutliers(
+    Stat stat, float sigmas, size_t max_results) const {
+  const size_t count = Size();
+  if (count < 2) {
+    return {};
+  }
+
+  // two passes over kept values, running sums of squares cancel out for
+  // values with large mean and small spread like frequency
+  const std::vector<float> &values =
+      this->stat_columns[static_cast<size_t>(stat)];
+  double sum = 0.0;
+  for (uint64_t id = this->first_id; id < this->next_id; id++) {
+    sum += values[SlotIndex(id)];
+  }
+  const double mean = sum / count;
+  double sum_squares = 0.0;
+  for (uint64_t id = this->first_id; id < this->next_id; id++) {
+    const double difference = values[SlotIndex(id)] - mean;
+    sum_squares += difference * difference;
+  }
+  const double deviation = sigmas * std::sqrt(sum_squares / count);
+
+  const float infinity = std::numeric_limits<float>::infinity();
+  std::vector<uint64_t> ids;
+  ScanRange(stat,
+            -infinity,
+            std::nextafter(float(mean - deviation), -infinity),
+            ids);
+  ScanRange(
+      stat, std::nextafter(float(mean + deviation), infinity), infinity, ids);
+  std::sort(ids.begin(), ids.end());
+  if (ids.size() > max_results) {
+    ids.erase(ids.begin(), ids.end() - max_results);
+  }
+  return ids;
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+void AcquisitionHistory::EvictOldest() {
+  this->first_id++;
+}
+
+bool AcquisitionHistory::Overlaps(const Slot &slot,
+                                  size_t offset,
+                                  size_t bytes) const {
+  return slot.offset < offset + bytes && offset < slot.offset + slot.bytes;
+}
+
+size_t AcquisitionHistory::SlotIndex(uint64_t id) const {
+  return (id - 1) % this->slots.size();
+}
+
+void AcquisitionHistory::ScanRange(Stat stat,
+                                   float low,
+                                   float high,
+                                   std::vector<uint64_t> &ids) const {
+  const size_t column = static_cast<size_t>(stat);
+  const std::vector<float> &values = this->stat_columns[column];
+
+  for (size_t block = 0; block < this->block_min[column].size(); block++) {
+    // zone map: skip blocks that cannot contain a match
+    if (this->block_max[column][block] < low ||
+        this->block_min[column][block] > high) {
+      continue;
+    }
+    const size_t block_end =
+        std::min((block + 1) * BLOCK_SIZE, this->slots.size());
+    for (size_t i = block * BLOCK_SIZE; i < block_end; i++) {
+      if (values[i] >= low && values[i] <= high &&
+          this->slots[i].id >= this->first_id) {
+        ids.push_back(this->slots[i].id);
+      }
+    }
+  }
+}
+/*
+ *   PRIVATE METHODS END
+ */
+} // namespace WaveformProcessing
@@ -0,0 +1,263 @@
+/*********************************************************************
+ * \file   AsciiCurveParser.cpp
+ * \brief  Definition of AsciiCurveParser class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "AsciiCurveParser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <future>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#define ASCII_CURVE_SSE2
+#endif
+
+namespace WaveformProcessing {
+// smaller replies are parsed by the calling thread, starting threads would
+// cost more than parsing
+constexpr size_t MIN_BYTES_PER_THREAD = 256 * 1024;
+constexpr char DELIMITER = ',';
+
+#ifdef ASCII_CURVE_SSE2
+static unsigned delimiterMask(const char *block) {
+  const __m128i bytes = _mm_loadu_si128((const __m128i *)block);
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(DELIMITER)));
+}
+
+static unsigned lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+static unsigned bitCount(unsigned mask) {
+#ifdef _MSC_VER
+  return __popcnt(mask);
+#else
+  return __builtin_popcount(mask);
+#endif
+}
+#endif
+
+static size_t countDelimiters(std::string_view text) {
+  size_t count = 0;
+  size_t i = 0;
+#ifdef ASCII_CURVE_SSE2
+  for (; i + 16 <= text.size(); i += 16) {
+    count += bitCount(delimiterMask(text.data() + i));
+  }
+#endif
+  for (; i < text.size(); i++) {
+    count += text[i] == DELIMITER;
+  }
+  return count;
+}
+
+template <typename T>
+static bool convertField(const char *first, const char *last, T &value) {
+  while (first < last && (*first == ' ' || *first == '+')) {
+    first++;
+  }
+  while (last > first && last[-1] == ' ') {
+    last--;
+  }
+  auto [end, error] = std::from_chars(first, last, value);
+  return error == std::errc() && end == last;
+}
+
+/**
+ * Converts all fields of text, which starts and ends at a field boundary.
+ * Returns number of values written or -1 on malformed field.
+ */
+template <typename T>
+static long long parseRange(std::string_view text, T *samples) {
+  const char *field = text.data();
+  const char *end = text.data() + text.size();
+  const char *position = text.data();
+  long long written = 0;
+#ifdef ASCII_CURVE_SSE2
+  for (; position + 16 <= end; position += 16) {
+    unsigned mask = delimiterMask(position);
+    while (mask != 0) {
+      const char *delimiter = position + lowestBit(mask);
+      if (!convertField(field, delimiter, samples[written++])) {
+        return -1;
+      }
+      field = delimiter + 1;
+      mask &= mask - 1;
+    }
+  }
+#endif
+  for (; position < end; position++) {
+    if (*position == DELIMITER) {
+      if (!convertField(field, position, samples[written++])) {
+        return -1;
+      }
+      field = position + 1;
+    }
+  }
+  if (!convertField(field, end, samples[written++])) {
+    return -1;
+  }
+  return written;
+}
+
+AsciiCurveParser::AsciiCurveParser(unsigned threads) : threads(threads) {
+  if (this->threads == 0) {
+    this->threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+size_t AsciiCurveParser::CountValues(std::string_view reply) const {
+  std::string_view payload = Payload(reply);
+  return payload.empty() ? 0 : countDelimiters(payload) + 1;
+}
+
+bool AsciiCurveParser::Parse(std::string_view reply,
+                             int16_t *samples,
+                             size_t capacity,
+                             size_t &count) const {
+  return ParseValues(reply, samples, capacity, count);
+}
+
+bool AsciiCurveParser::Parse(std::string_view reply,
+                             float *samples,
+                             size_t capacity,
+                             size_t &count) const {
+  return ParseValues(reply, samples, capacity, count);
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+template <typename T>
+bool AsciiCurveParser::ParseValues(std::string_view reply,
+                                   T *samples,
+                                   size_t capacity,
+                                   size_t &count) const {
+  count = 0;
+  std::string_view payload = Payload(reply);
+  if (payload.empty()) {
+    return true;
+  }
+  std::vector<std::string_view> ranges = Split(payload);
+
+  // output offset of every range from number of delimiters before it
+  std::vector<size_t> offsets(ranges.size() + 1, 0);
+  std::vector<std::future<size_t>> counting;
+  for (size_t i = 1; i < ranges.size(); i++) {
+    counting.push_back(std::async(
+        std::launch::async, countDelimiters, ranges[i]));
+  }
+  offsets[1] = countDelimiters(ranges[0]) + 1;
+  for (size_t i = 1; i < ranges.size(); i++) {
+    offsets[i + 1] = offsets[i] + counting[i - 1].get() + 1;
+  }
+  if (offsets.back() > capacity) {
+    spdlog::error("ASCII curve of {} values does not fit buffer of {}",
+                  offsets.back(),
+                  capacity);
+    return false;
+  }
+
+  std::vector<std::future<long long>> parsing;
+  for (size_t i = 1; i < ranges.size(); i++) {
+    parsing.push_back(std::async(
+        std::launch::async, parseRange<T>, ranges[i], samples + offsets[i]));
+  }
+  bool success = parseRange(ranges[0], samples) >= 0;
+  for (auto &task : parsing) {
+    success = task.get() >= 0 && success;
+  }
+  if (!success) {
+    spdlog::error("Malformed value in ASCII curve data");
+    return false;
+  }
+
+  count = offsets.back();
+  spdlog::debug("Parsed {} ASCII curve values using {} ranges",
+                count,
+                ranges.size());
+  return true;
+}
+
+/**
+ * Strips command header (":CURVE "), block header ("#<n><length>"), each
+ * optional and in that order, surrounding whitespace and terminator.
+ */
+std::string_view AsciiCurveParser::Payload(std::string_view reply) const {
+  while (!reply.empty() && std::isspace((unsigned char)reply.back())) {
+    reply.remove_suffix(1);
+  }
+  while (!reply.empty() && std::isspace((unsigned char)reply.front())) {
+    reply.remove_prefix(1);
+  }
+  if (reply.empty()) {
+    return reply;
+  }
+
+  auto skipSpaces = [&reply]() {
+    while (!reply.empty() && reply.front() == ' ') {
+      reply.remove_prefix(1);
+    }
+  };
+  if (reply.front() == ':' || std::isalpha((unsigned char)reply.front())) {
+    size_t space = reply.find(' ');
+    reply.remove_prefix(space == std::string_view::npos ? reply.size()
+                                                        : space + 1);
+    skipSpaces();
+  }
+  if (reply.size() >= 2 && reply.front() == '#' &&
+      std::isdigit((unsigned char)reply[1])) {
+    reply.remove_prefix(std::min<size_t>(reply.size(), 2 + (reply[1] - '0')));
+    skipSpaces();
+  }
+  return reply;
+}
+
+/**
+ * Splits payload into ranges of whole fields, one per thread. Each range
+ * but the last ends just before a delimiter.
+ */
+std::vector<std::string_view>
+AsciiCurveParser::Split(std::string_view payload) const {
+  const size_t parts = std::clamp<size_t>(
+      payload.size() / MIN_BYTES_PER_THREAD, 1, this->threads);
+  std::vector<std::string_view> ranges;
+  size_t begin = 0;
+  for (size_t part = 1; part < parts && begin < payload.size(); part++) {
+    size_t end = payload.find(DELIMITER,
+                              std::max(begin, payload.size() * part / parts));
+    if (end == std::string_view::npos) {
+      break;
+    }
+    ranges.push_back(payload.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  ranges.push_back(payload.substr(begin));
+  return ranges;
+}
+/*
+ *   PRIVATE METHODS END
+ */
+} // namespace WaveformProcessing
@@ -0,0 +1,455 @@
+/*********************************************************************
+ * \file   FftPlan.cpp
+ * \brief  Definition of FftPlan class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "FftPlan.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace WaveformProcessing {
+// plans kept for the lengths used most recently, records rarely change
+// length so a handful is plenty
+constexpr size_t MAX_CACHED_PLANS = 8;
+constexpr double PI = 3.14159265358979323846;
+
+static size_t largestPrimeFactor(size_t value) {
+  size_t largest = 1;
+  for (size_t factor = 2; factor * factor <= value; factor++) {
+    while (value % factor == 0) {
+      largest = factor;
+      value /= factor;
+    }
+  }
+  return std::max(largest, value);
+}
+
+// smallest length not below minimum with no prime factor above 5
+static size_t smoothLength(size_t minimum) {
+  for (size_t length = minimum;; length++) {
+    size_t remaining = length;
+    for (size_t radix : {2, 3, 5}) {
+      while (remaining % radix == 0) {
+        remaining /= radix;
+      }
+    }
+    if (remaining == 1) {
+      return length;
+    }
+  }
+}
+
+FftPlan::FftPlan(size_t length) : length(length & ~size_t(1)) {
+  this->half = std::max<size_t>(this->length / 2, 1);
+  if (this->length != length) {
+    spdlog::warn("FFT length {} is odd, last sample ignored", length);
+  }
+
+  this->split_re.resize(this->half / 2 + 1);
+  this->split_im.resize(this->half / 2 + 1);
+  for (size_t k = 0; k < this->split_re.size(); k++) {
+    const double angle = -2.0 * PI * (double)k / (2 * this->half);
+    this->split_re[k] = std::cos(angle);
+    this->split_im[k] = std::sin(angle);
+  }
+
+  if (largestPrimeFactor(this->half) > MAX_DIRECT_RADIX) {
+    PrepareChirp();
+    return;
+  }
+
+  // radix 4 first as it needs the fewest operations per point
+  std::vector<size_t> radices;
+  size_t remaining = this->half;
+  for (size_t radix : {4, 2, 3, 5}) {
+    while (remaining % radix == 0) {
+      radices.push_back(radix);
+      remaining /= radix;
+    }
+  }
+  for (size_t radix = 7; remaining > 1; radix += 2) {
+    while (remaining % radix == 0) {
+      radices.push_back(radix);
+      remaining /= radix;
+    }
+  }
+
+  size_t stride = 1;
+  for (size_t radix : radices) {
+    Stage stage;
+    stage.radix = radix;
+    stage.stride = stride;
+    stage.span = this->half / (stride * radix);
+    const size_t sub_length = stage.span * radix;
+    stage.twiddle_re.resize(stage.span * (radix - 1));
+    stage.twiddle_im.resize(stage.span * (radix - 1));
+    for (size_t p = 0; p < stage.span; p++) {
+      for (size_t j = 1; j < radix; j++) {
+        const double angle = -2.0 * PI * (double)(p * j) / sub_length;
+        stage.twiddle_re[p * (radix - 1) + j - 1] = std::cos(angle);
+        stage.twiddle_im[p * (radix - 1) + j - 1] = std::sin(angle);
+      }
+    }
+    if (radix > 5) {
+      stage.root_re.resize(radix * radix);
+      stage.root_im.resize(radix * radix);
+      for (size_t j = 0; j < radix; j++) {
+        for (size_t k = 0; k < radix; k++) {
+          const double angle = -2.0 * PI * (double)((j * k) % radix) / radix;
+          stage.root_re[j * radix + k] = std::cos(angle);
+          stage.root_im[j * radix + k] = std::sin(angle);
+        }
+      }
+    }
+    this->stages.push_back(std::move(stage));
+    stride *= radix;
+  }
+}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+std::shared_ptr<const FftPlan> FftPlan::Get(size_t length) {
+  static std::mutex cache_mutex;
+  static std::map<size_t, std::shared_ptr<const FftPlan>> cache;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto found = cache.find(length);
+  if (found != cache.end()) {
+    return found->second;
+  }
+  if (cache.size() >= MAX_CACHED_PLANS) {
+    cache.clear(); // plans still in use are kept alive by their users
+  }
+  auto plan = std::make_shared<const FftPlan>(length);
+  cache[length] = plan;
+  spdlog::debug("FFT plan for {} points with {} stages created",
+                length,
+                plan->stages.size());
+  return plan;
+}
+
+size_t FftPlan::Length() const {
+  return this->length;
+}
+
+size_t FftPlan::BinCount() const {
+  return this->half + 1;
+}
+
+/**
+ * Transforms Length() real samples from input, result is left in
+ * workspace.bin_re/bin_im.
+ */
+void FftPlan::Transform(const float *input, FftWorkspace &workspace) const {
+  const size_t half = this->half;
+  workspace.re.resize(half);
+  workspace.im.resize(half);
+  workspace.work_re.resize(half);
+  workspace.work_im.resize(half);
+  workspace.bin_re.resize(half + 1);
+  workspace.bin_im.resize(half + 1);
+  if (this->length < 2) {
+    std::fill(workspace.bin_re.begin(), workspace.bin_re.end(), 0.0f);
+    std::fill(workspace.bin_im.begin(), workspace.bin_im.end(), 0.0f);
+    return;
+  }
+
+  // even samples go to real part, odd samples to imaginary part
+  float *x_re = workspace.re.data();
+  float *x_im = workspace.im.data();
+  for (size_t i = 0; i < half; i++) {
+    x_re[i] = input[2 * i];
+    x_im[i] = input[2 * i + 1];
+  }
+
+  float *y_re = workspace.work_re.data();
+  float *y_im = workspace.work_im.data();
+  if (this->chirp) {
+    RunChirp(x_re, x_im, workspace);
+  } else {
+    RunStages(x_re, x_im, y_re, y_im);
+  }
+
+  // X[k] = E + W^k O and X[half - k] = conj(E - W^k O), where E and O are
+  // spectra of even and odd samples recovered from Z[k] and Z[half - k]
+  float *bin_re = workspace.bin_re.data();
+  float *bin_im = workspace.bin_im.data();
+  for (size_t k = 0; k <= half / 2; k++) {
+    const size_t mirror = (half - k) % half;
+    const float even_re = 0.5f * (x_re[k] + x_re[mirror]);
+    const float even_im = 0.5f * (x_im[k] - x_im[mirror]);
+    const float odd_re = 0.5f * (x_im[k] + x_im[mirror]);
+    const float odd_im = -0.5f * (x_re[k] - x_re[mirror]);
+    const float rotated_re =
+        this->split_re[k] * odd_re - this->split_im[k] * odd_im;
+    const float rotated_im =
+        this->split_re[k] * odd_im + this->split_im[k] * odd_re;
+    bin_re[k] = even_re + rotated_re;
+    bin_im[k] = even_im + rotated_im;
+    bin_re[half - k] = even_re - rotated_re;
+    bin_im[half - k] = -(even_im - rotated_im);
+  }
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+/**
+ * Bluestein: X[k] = w[k] sum x[n] w[n] conj(w[k - n]) with
+ * w[k] = e^(-pi i k^2 / half), a circular convolution computed with
+ * transforms of smooth length at least 2 half - 1.
+ */
+void FftPlan::PrepareChirp() {
+  const size_t half = this->half;
+  const size_t length = smoothLength(2 * half - 1);
+  // plan of 2 length real points runs complex stages of length points
+  this->chirp = std::make_shared<const FftPlan>(2 * length);
+
+  this->chirp_w_re.resize(half);
+  this->chirp_w_im.resize(half);
+  for (size_t k = 0; k < half; k++) {
+    // k^2 reduced modulo 2 half in integers keeps the angle exact
+    const double angle = -PI * (double)((k * k) % (2 * half)) / half;
+    this->chirp_w_re[k] = std::cos(angle);
+    this->chirp_w_im[k] = std::sin(angle);
+  }
+
+  std::vector<float> b_re(length, 0.0f), b_im(length, 0.0f);
+  std::vector<float> work_re(length), work_im(length);
+  for (size_t k = 0; k < half; k++) {
+    b_re[k] = this->chirp_w_re[k];
+    b_im[k] = -this->chirp_w_im[k];
+    if (k > 0) {
+      b_re[length - k] = b_re[k];
+      b_im[length - k] = b_im[k];
+    }
+  }
+  float *x_re = b_re.data(), *x_im = b_im.data();
+  float *y_re = work_re.data(), *y_im = work_im.data();
+  this->chirp->RunStages(x_re, x_im, y_re, y_im);
+  // inverse transform scaling folded into the kernel
+  this->chirp_b_re.assign(x_re, x_re + length);
+  this->chirp_b_im.assign(x_im, x_im + length);
+  for (size_t k = 0; k < length; k++) {
+    this->chirp_b_re[k] /= length;
+    this->chirp_b_im[k] /= length;
+  }
+}
+
+// complex transform of half points, pointers are left at the result
+void FftPlan::RunStages(float *&x_re,
+                        float *&x_im,
+                        float *&y_re,
+                        float *&y_im) const {
+  for (const Stage &stage : this->stages) {
+    RunStage(stage, x_re, x_im, y_re, y_im);
+    std::swap(x_re, y_re);
+    std::swap(x_im, y_im);
+  }
+}
+
+// complex transform of half points in place, see PrepareChirp()
+void FftPlan::RunChirp(float *x_re,
+                       float *x_im,
+                       FftWorkspace &workspace) const {
+  const size_t half = this->half;
+  const size_t length = this->chirp_b_re.size();
+  workspace.chirp_re.assign(length, 0.0f);
+  workspace.chirp_im.assign(length, 0.0f);
+  workspace.chirp_work_re.resize(length);
+  workspace.chirp_work_im.resize(length);
+  float *a_re = workspace.chirp_re.data();
+  float *a_im = workspace.chirp_im.data();
+  float *b_re = workspace.chirp_work_re.data();
+  float *b_im = workspace.chirp_work_im.data();
+  const float *w_re = this->chirp_w_re.data();
+  const float *w_im = this->chirp_w_im.data();
+
+  for (size_t k = 0; k < half; k++) {
+    a_re[k] = x_re[k] * w_re[k] - x_im[k] * w_im[k];
+    a_im[k] = x_re[k] * w_im[k] + x_im[k] * w_re[k];
+  }
+  this->chirp->RunStages(a_re, a_im, b_re, b_im);
+
+  // product with the kernel, conjugated so the forward stages invert it
+  const float *k_re = this->chirp_b_re.data();
+  const float *k_im = this->chirp_b_im.data();
+  for (size_t k = 0; k < length; k++) {
+    const float product_re = a_re[k] * k_re[k] - a_im[k] * k_im[k];
+    const float product_im = a_re[k] * k_im[k] + a_im[k] * k_re[k];
+    a_re[k] = product_re;
+    a_im[k] = -product_im;
+  }
+  this->chirp->RunStages(a_re, a_im, b_re, b_im);
+
+  for (size_t k = 0; k < half; k++) {
+    const float c_re = a_re[k];
+    const float c_im = -a_im[k];
+    x_re[k] = c_re * w_re[k] - c_im * w_im[k];
+    x_im[k] = c_re * w_im[k] + c_im * w_re[k];
+  }
+}
+
+void FftPlan::RunStage(const Stage &stage,
+                       const float *x_re,
+                       const float *x_im,
+                       float *y_re,
+                       float *y_im) const {
+  const size_t s = stage.stride;
+  const size_t m = stage.span;
+  const size_t r = stage.radix;
+  constexpr float SIN_60 = 0.86602540378443864676f;
+  constexpr float COS_72 = 0.30901699437494742410f;
+  constexpr float COS_144 = -0.80901699437494742410f;
+  constexpr float SIN_72 = 0.95105651629515357212f;
+  constexpr float SIN_144 = 0.58778525229247312917f;
+
+  for (size_t p = 0; p < m; p++) {
+    const float *w_re = &stage.twiddle_re[p * (r - 1)];
+    const float *w_im = &stage.twiddle_im[p * (r - 1)];
+    // inputs x[q + s * (p + k * m)], outputs y[q + s * (r * p + j)]
+    const float *a_re = x_re + s * p;
+    const float *a_im = x_im + s * p;
+    float *b_re = y_re + s * r * p;
+    float *b_im = y_im + s * r * p;
+    const size_t in_step = s * m;
+
+    switch (r) {
+    case 2:
+      for (size_t q = 0; q < s; q++) {
+        const float d_re = a_re[q] - a_re[q + in_step];
+        const float d_im = a_im[q] - a_im[q + in_step];
+        b_re[q] = a_re[q] + a_re[q + in_step];
+        b_im[q] = a_im[q] + a_im[q + in_step];
+        b_re[q + s] = d_re * w_re[0] - d_im * w_im[0];
+        b_im[q + s] = d_re * w_im[0] + d_im * w_re[0];
+      }
+      break;
+    case 3:
+      for (size_t q = 0; q < s; q++) {
+        const float t_re = a_re[q + in_step] + a_re[q + 2 * in_step];
+        const float t_im = a_im[q + in_step] + a_im[q + 2 * in_step];
+        const float m_re = a_re[q] - 0.5f * t_re;
+        const float m_im = a_im[q] - 0.5f * t_im;
+        // -i * sin(60) * (a1 - a2)
+        const float n_re =
+            SIN_60 * (a_im[q + in_step] - a_im[q + 2 * in_step]);
+        const float n_im =
+            -SIN_60 * (a_re[q + in_step] - a_re[q + 2 * in_step]);
+        const float c1_re = m_re + n_re;
+        const float c1_im = m_im + n_im;
+        const float c2_re = m_re - n_re;
+        const float c2_im = m_im - n_im;
+        b_re[q] = a_re[q] + t_re;
+        b_im[q] = a_im[q] + t_im;
+        b_re[q + s] = c1_re * w_re[0] - c1_im * w_im[0];
+        b_im[q + s] = c1_re * w_im[0] + c1_im * w_re[0];
+        b_re[q + 2 * s] = c2_re * w_re[1] - c2_im * w_im[1];
+        b_im[q + 2 * s] = c2_re * w_im[1] + c2_im * w_re[1];
+      }
+      break;
+    case 4:
+      for (size_t q = 0; q < s; q++) {
+        const float a0_re = a_re[q], a0_im = a_im[q];
+        const float a1_re = a_re[q + in_step], a1_im = a_im[q + in_step];
+        const float a2_re = a_re[q + 2 * in_step];
+        const float a2_im = a_im[q + 2 * in_step];
+        const float a3_re = a_re[q + 3 * in_step];
+        const float a3_im = a_im[q + 3 * in_step];
+        const float t0_re = a0_re + a2_re, t0_im = a0_im + a2_im;
+        const float t1_re = a0_re - a2_re, t1_im = a0_im - a2_im;
+        const float t2_re = a1_re + a3_re, t2_im = a1_im + a3_im;
+        // -i * (a1 - a3)
+        const float t3_re = a1_im - a3_im, t3_im = a3_re - a1_re;
+        const float c1_re = t1_re + t3_re, c1_im = t1_im + t3_im;
+        const float c2_re = t0_re - t2_re, c2_im = t0_im - t2_im;
+        const float c3_re = t1_re - t3_re, c3_im = t1_im - t3_im;
+        b_re[q] = t0_re + t2_re;
+        b_im[q] = t0_im + t2_im;
+        b_re[q + s] = c1_re * w_re[0] - c1_im * w_im[0];
+        b_im[q + s] = c1_re * w_im[0] + c1_im * w_re[0];
+        b_re[q + 2 * s] = c2_re * w_re[1] - c2_im * w_im[1];
+        b_im[q + 2 * s] = c2_re * w_im[1] + c2_im * w_re[1];
+        b_re[q + 3 * s] = c3_re * w_re[2] - c3_im * w_im[2];
+        b_im[q + 3 * s] = c3_re * w_im[2] + c3_im * w_re[2];
+      }
+      break;
+    case 5:
+      for (size_t q = 0; q < s; q++) {
+        const float a1_re = a_re[q + in_step], a1_im = a_im[q + in_step];
+        const float a2_re = a_re[q + 2 * in_step];
+        const float a2_im = a_im[q + 2 * in_step];
+        const float a3_re = a_re[q + 3 * in_step];
+        const float a3_im = a_im[q + 3 * in_step];
+        const float a4_re = a_re[q + 4 * in_step];
+        const float a4_im = a_im[q + 4 * in_step];
+        const float t1_re = a1_re + a4_re, t1_im = a1_im + a4_im;
+        const float t2_re = a2_re + a3_re, t2_im = a2_im + a3_im;
+        const float t3_re = a1_re - a4_re, t3_im = a1_im - a4_im;
+        const float t4_re = a2_re - a3_re, t4_im = a2_im - a3_im;
+        const float m1_re = a_re[q] + COS_72 * t1_re + COS_144 * t2_re;
+        const float m1_im = a_im[q] + COS_72 * t1_im + COS_144 * t2_im;
+        const float m2_re = a_re[q] + COS_144 * t1_re + COS_72 * t2_re;
+        const float m2_im = a_im[q] + COS_144 * t1_im + COS_72 * t2_im;
+        // -i * n1 and -i * n2
+        const float n1_re = SIN_72 * t3_im + SIN_144 * t4_im;
+        const float n1_im = -(SIN_72 * t3_re + SIN_144 * t4_re);
+        const float n2_re = SIN_144 * t3_im - SIN_72 * t4_im;
+        const float n2_im = -(SIN_144 * t3_re - SIN_72 * t4_re);
+        const float c1_re = m1_re + n1_re, c1_im = m1_im + n1_im;
+        const float c2_re = m2_re + n2_re, c2_im = m2_im + n2_im;
+        const float c3_re = m2_re - n2_re, c3_im = m2_im - n2_im;
+        const float c4_re = m1_re - n1_re, c4_im = m1_im - n1_im;
+        b_re[q] = a_re[q] + t1_re + t2_re;
+        b_im[q] = a_im[q] + t1_im + t2_im;
+        b_re[q + s] = c1_re * w_re[0] - c1_im * w_im[0];
+        b_im[q + s] = c1_re * w_im[0] + c1_im * w_re[0];
+        b_re[q + 2 * s] = c2_re * w_re[1] - c2_im * w_im[1];
+        b_im[q + 2 * s] = c2_re * w_im[1] + c2_im * w_re[1];
+        b_re[q + 3 * s] = c3_re * w_re[2] - c3_im * w_im[2];
+        b_im[q + 3 * s] = c3_re * w_im[2] + c3_im * w_re[2];
+        b_re[q + 4 * s] = c4_re * w_re[3] - c4_im * w_im[3];
+        b_im[q + 4 * s] = c4_re * w_im[3] + c4_im * w_re[3];
+      }
+      break;
+    default:
+      // direct DFT of radix points
+      for (size_t q = 0; q < s; q++) {
+        for (size_t j = 0; j < r; j++) {
+          float c_re = 0.0f;
+          float c_im = 0.0f;
+          for (size_t k = 0; k < r; k++) {
+            const float root_re = stage.root_re[j * r + k];
+            const float root_im = stage.root_im[j * r + k];
+            const float v_re = a_re[q + k * in_step];
+            const float v_im = a_im[q + k * in_step];
+            c_re += v_re * root_re - v_im * root_im;
+            c_im += v_re * root_im + v_im * root_re;
+          }
+          if (j == 0) {
+            b_re[q] = c_re;
+            b_im[q] = c_im;
+          } else {
+            b_re[q + j * s] = c_re * w_re[j - 1] - c_im * w_im[j - 1];
+            b_im[q + j * s] = c_re * w_im[j - 1] + c_im * w_re[j - 1];
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+/*
+ *   PRIVATE METHODS END
+ */
+} // namespace WaveformProcessing
@@ -0,0 +1,364 @@
+/*********************************************************************
+ * \file   FirFilter.cpp
+ * \brief  Definition of FirFilter class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "FirFilter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FIR_FILTER_SSE2
+#endif
+
+namespace WaveformProcessing {
+constexpr double PI = 3.14159265358979323846;
+// default upper cutoff relative to Nyquist frequency after decimation,
+// leaves room for the transition band of short filters
+constexpr double DEFAULT_CUTOFF_FRACTION = 0.8;
+constexpr size_t MIN_TAPS = 3;
+
+/**
+ * Blackman windowed sinc low-pass with unity gain at DC, cutoff relative
+ * to sample rate.
+ */
+static std::vector<double> designLowPass(double cutoff, size_t taps) {
+  std::vector<double> taps_values(taps);
+  const double middle = (taps - 1) / 2.0;
+  double sum = 0.0;
+  for (size_t n = 0; n < taps; n++) {
+    const double x = n - middle;
+    const double sinc =
+        x == 0.0 ? 2.0 * cutoff
+                 : std::sin(2.0 * PI * cutoff * x) / (PI * x);
+    const double phase = 2.0 * PI * n / (taps - 1);
+    const double window =
+        0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+    taps_values[n] = sinc * window;
+    sum += taps_values[n];
+  }
+  for (double &value : taps_values) {
+    value /= sum;
+  }
+  return taps_values;
+}
+
+static double gainAt(const std::vector<double> &taps_values,
+                     double frequency) {
+  std::complex<double> response = 0.0;
+  for (size_t n = 0; n < taps_values.size(); n++) {
+    response += taps_values[n] * std::polar(1.0, -2.0 * PI * frequency * n);
+  }
+  return std::abs(response);
+}
+
+static float dotProduct(const float *a, const float *b, size_t count) {
+  size_t i = 0;
+  float sum = 0.0f;
+#ifdef FIR_FILTER_SSE2
+  // two accumulators hide latency of the additions
+  __m128 sum_low = _mm_setzero_ps();
+  __m128 sum_high = _mm_setzero_ps();
+  for (; i + 8 <= count; i += 8) {
+    sum_low = _mm_add_ps(
+        sum_low, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    sum_high = _mm_add_ps(
+        sum_high,
+        _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, _mm_add_ps(sum_low, sum_high));
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+  for (; i < count; i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+static void convertSamples(const float *input, size_t count, float *output) {
+  std::memcpy(output, input, count * sizeof(float));
+}
+
+static void convertSamples(const int16_t *input,
+                           size_t count,
+                           float *output) {
+  size_t i = 0;
+#ifdef FIR_FILTER_SSE2
+  for (; i + 8 <= count; i += 8) {
+    const __m128i codes = _mm_loadu_si128((const __m128i *)(input + i));
+    // sample in upper half of 32 bit lane, arithmetic shift sign extends
+    const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(codes, codes), 16);
+    const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(codes, codes), 16);
+    _mm_storeu_ps(output + i, _mm_cvtepi32_ps(low));
+    _mm_storeu_ps(output + i + 4, _mm_cvtepi32_ps(high));
+  }
+#endif
+  for (; i < count; i++) {
+    output[i] = input[i];
+  }
+}
+
+/**
+ * Big endian codes to signed 16 bit, unsigned codes are moved by half of
+ * their range.
+ */
+static void decodeCodes(const uint8_t *samples,
+                        const RecordMetadata &metadata,
+                        int16_t *codes) {
+  const size_t count = metadata.sample_count;
+  size_t i = 0;
+  if (metadata.sample_width == 2) {
+    const uint16_t flip = metadata.signed_samples ? 0 : 0x8000;
+#ifdef FIR_FILTER_SSE2
+    const __m128i flip_bits = _mm_set1_epi16((short)flip);
+    for (; i + 8 <= count; i += 8) {
+      const __m128i bytes =
+          _mm_loadu_si128((const __m128i *)(samples + 2 * i));
+      const __m128i swapped =
+          _mm_or_si128(_mm_slli_epi16(bytes, 8), _mm_srli_epi16(bytes, 8));
+      _mm_storeu_si128((__m128i *)(codes + i),
+                       _mm_xor_si128(swapped, flip_bits));
+    }
+#endif
+    for (; i < count; i++) {
+      codes[i] = (int16_t)((samples[2 * i] << 8 | samples[2 * i + 1]) ^ flip);
+    }
+  } else {
+    for (; i < count; i++) {
+      codes[i] = metadata.signed_samples ? (int8_t)samples[i]
+                                         : (int16_t)(samples[i] - 128);
+    }
+  }
+}
+
+/**
+ * Filtered values times scale, rounded and saturated to big endian signed
+ * 16 bit codes.
+ */
+static void encodeCodes(const float *values,
+                        size_t count,
+                        float scale,
+                        uint8_t *samples) {
+  size_t i = 0;
+#ifdef FIR_FILTER_SSE2
+  const __m128 scales = _mm_set1_ps(scale);
+  for (; i + 8 <= count; i += 8) {
+    // conversion rounds to nearest, packing saturates
+    const __m128i low =
+        _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(values + i), scales));
+    const __m128i high =
+        _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(values + i + 4), scales));
+    const __m128i codes = _mm_packs_epi32(low, high);
+    _mm_storeu_si128(
+        (__m128i *)(samples + 2 * i),
+        _mm_or_si128(_mm_slli_epi16(codes, 8), _mm_srli_epi16(codes, 8)));
+  }
+#endif
+  for (; i < count; i++) {
+    const float code = std::clamp(std::nearbyint(values[i] * scale),
+                                  (float)INT16_MIN,
+                                  (float)INT16_MAX);
+    const uint16_t bits = (uint16_t)(int16_t)code;
+    samples[2 * i] = (uint8_t)(bits >> 8);
+    samples[2 * i + 1] = (uint8_t)bits;
+  }
+}
+
+FirFilter::FirFilter(const FilterSettings &settings) : settings(settings) {}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+void FirFilter::SetSettings(const FilterSettings &settings) {
+  this->settings = settings;
+  // coefficients are designed again with the next record
+  this->sample_rate = 0.0;
+  this->coefficients.clear();
+  Reset();
+}
+
+const FilterSettings &FirFilter::GetSettings() const {
+  return this->settings;
+}
+
+const std::vector<float> &FirFilter::GetCoefficients() const {
+  return this->coefficients;
+}
+
+bool FirFilter::Design(double sample_rate) {
+  const size_t taps = std::max(this->settings.taps, MIN_TAPS) | 1;
+  const size_t decimation = std::max<size_t>(this->settings.decimation, 1);
+  const double nyquist = sample_rate / 2.0;
+  const double output_nyquist = nyquist / decimation;
+  const double high_cutoff = this->settings.high_cutoff > 0.0
+                                 ? this->settings.high_cutoff
+                                 : DEFAULT_CUTOFF_FRACTION * output_nyquist;
+  const double low_cutoff = this->settings.low_cutoff;
+
+  if (!(sample_rate > 0.0)) {
+    spdlog::error("Cannot design filter for sample rate {}", sample_rate);
+    return false;
+  }
+  if (high_cutoff >= nyquist) {
+    spdlog::error("Filter cutoff {} Hz is above Nyquist frequency {} Hz",
+                  high_cutoff,
+                  nyquist);
+    return false;
+  }
+  if (this->settings.type == FilterType::BandPass &&
+      !(low_cutoff > 0.0 && low_cutoff < high_cutoff)) {
+    spdlog::error("Band-pass filter needs 0 < low cutoff < high cutoff, "
+                  "got {} Hz and {} Hz",
+                  low_cutoff,
+                  high_cutoff);
+    return false;
+  }
+  if (high_cutoff > output_nyquist) {
+    spdlog::warn("Filter cutoff {} Hz is above Nyquist frequency {} Hz "
+                 "after decimation by {}, signal will alias",
+                 high_cutoff,
+                 output_nyquist,
+                 decimation);
+  }
+
+  std::vector<double> taps_values =
+      designLowPass(high_cutoff / sample_rate, taps);
+  if (this->settings.type == FilterType::BandPass) {
+    // difference of low-passes passes the band between their cutoffs
+    const std::vector<double> low_pass =
+        designLowPass(low_cutoff / sample_rate, taps);
+    for (size_t n = 0; n < taps; n++) {
+      taps_values[n] -= low_pass[n];
+    }
+    const double gain =
+        gainAt(taps_values, (low_cutoff + high_cutoff) / 2.0 / sample_rate);
+    for (double &value : taps_values) {
+      value /= gain;
+    }
+  }
+
+  this->coefficients.assign(taps_values.rbegin(), taps_values.rend());
+  this->dc_gain = 0.0;
+  for (float coefficient : this->coefficients) {
+    this->dc_gain += coefficient;
+  }
+  this->sample_rate = sample_rate;
+  Reset();
+  return true;
+}
+
+void FirFilter::Reset() {
+  this->skip = 0;
+  this->primed = false;
+}
+
+size_t FirFilter::OutputCount(size_t input_count) const {
+  const size_t decimation = std::max<size_t>(this->settings.decimation, 1);
+  return input_count > this->skip
+             ? (input_count - this->skip + decimation - 1) / decimation
+             : 0;
+}
+
+size_t FirFilter::Process(const float *input, size_t count, float *output) {
+  return Filter(input, count, output);
+}
+
+size_t FirFilter::Process(const int16_t *input, size_t count, float *output) {
+  return Filter(input, count, output);
+}
+
+bool FirFilter::ProcessRecord(const uint8_t *samples,
+                              const RecordMetadata &metadata,
+                              RecordMetadata &filtered_metadata,
+                              std::vector<uint8_t> &filtered) {
+  if (metadata.sample_width != 1 && metadata.sample_width != 2) {
+    spdlog::error("Cannot filter samples of {} bytes", metadata.sample_width);
+    return false;
+  }
+  const double sample_rate = 1.0 / metadata.scaling.x_increment;
+  if (this->coefficients.empty() ||
+      std::abs(sample_rate - this->sample_rate) > 1e-9 * sample_rate) {
+    if (!Design(sample_rate)) {
+      return false;
+    }
+  }
+
+  this->codes.resize(metadata.sample_count);
+  decodeCodes(samples, metadata, this->codes.data());
+  this->output.resize(OutputCount(metadata.sample_count));
+  const size_t count =
+      Process(this->codes.data(), this->codes.size(), this->output.data());
+
+  // 8 bit codes get 8 more bits of resolution gained by averaging
+  const float scale = metadata.sample_width == 1 ? 256.0f : 1.0f;
+  filtered.resize(2 * count);
+  encodeCodes(this->output.data(), count, scale, filtered.data());
+
+  // volts = (code - ref) * inc + origin with code moved to signed range,
+  // filter sums coefficient times volts of each input
+  const WaveformScaling &scaling = metadata.scaling;
+  const double reference =
+      scaling.y_reference -
+      (metadata.signed_samples ? 0 : metadata.sample_width == 2 ? 32768 : 128);
+  filtered_metadata = metadata;
+  filtered_metadata.scaling.x_increment =
+      scaling.x_increment * std::max<size_t>(this->settings.decimation, 1);
+  filtered_metadata.scaling.y_increment = scaling.y_increment / scale;
+  filtered_metadata.scaling.y_reference = 0.0;
+  filtered_metadata.scaling.y_origin =
+      this->dc_gain * (scaling.y_origin - reference * scaling.y_increment);
+  filtered_metadata.sample_width = 2;
+  filtered_metadata.signed_samples = true;
+  filtered_metadata.sample_count = (uint32_t)count;
+  return true;
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+template <typename Sample>
+size_t FirFilter::Filter(const Sample *input, size_t count, float *output) {
+  const size_t taps = this->coefficients.size();
+  if (taps == 0 || count == 0) {
+    return 0;
+  }
+  const size_t history = taps - 1;
+  const size_t decimation = std::max<size_t>(this->settings.decimation, 1);
+
+  this->window.resize(history + count);
+  convertSamples(input, count, this->window.data() + history);
+  if (!this->primed) {
+    // stream starts as if the first value lasted forever, no step from 0
+    std::fill_n(this->window.begin(), history, this->window[history]);
+    this->primed = true;
+  }
+
+  // output j uses inputs j - history .. j, other outputs are dropped by
+  // decimation so they are not computed at all
+  size_t produced = 0;
+  size_t j = this->skip;
+  for (; j < count; j += decimation) {
+    output[produced++] =
+        dotProduct(this->coefficients.data(), this->window.data() + j, taps);
+  }
+  this->skip = j - count;
+
+  std::memmove(this->window.data(),
+               this->window.data() + count,
+               history * sizeof(float));
+  return produced;
+}
+/*
+ *   PRIVATE METHODS END
+ */
+} // namespace WaveformProcessing
@@ -0,0 +1,291 @@
+/*********************************************************************
+ * \file   SpectrumAnalyzer.cpp
+ * \brief  Definition of SpectrumAnalyzer class
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "SpectrumAnalyzer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <spdlog/spdlog.h>
+
+namespace WaveformProcessing {
+// shorter segments give too coarse resolution to separate harmonics
+constexpr size_t MIN_SEGMENT_LENGTH = 16;
+constexpr double TWO_PI = 6.28318530717958647692;
+// bins next to a tone lobe above this many times the median bin power are
+// window leakage of the tone, not noise
+constexpr double LEAKAGE_THRESHOLD = 3.0;
+
+/**
+ * Bins on each side of a tone holding its main lobe.
+ */
+static size_t lobeHalfWidth(WindowType window) {
+  switch (window) {
+  case WindowType::Blackman:
+    return 3;
+  case WindowType::FlatTop:
+    return 5;
+  case WindowType::Hann:
+  default:
+    return 2;
+  }
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(const SpectrumSettings &settings)
+    : settings(settings) {}
+
+/*
+ * PUBLIC METHODS BEGIN
+ */
+void SpectrumAnalyzer::SetSettings(const SpectrumSettings &settings) {
+  if (settings.window != this->settings.window) {
+    this->windows.clear();
+  }
+  this->settings = settings;
+  this->settings.overlap = std::clamp(this->settings.overlap, 0.0, 0.95);
+}
+
+const SpectrumSettings &SpectrumAnalyzer::GetSettings() const {
+  return this->settings;
+}
+
+/**
+ * Returns spectra in the order of inputs. Inputs too short to analyze give
+ * a spectrum without bins.
+ */
+std::vector<Spectrum>
+SpectrumAnalyzer::Analyze(const std::vector<SpectrumInput> &inputs) {
+  std::vector<Spectrum> spectra(inputs.size());
+  if (this->workspaces.size() < inputs.size()) {
+    this->workspaces.resize(inputs.size());
+  }
+
+  // window tables are shared, so they are built before work is spread
+  std::vector<const WindowTable *> tables(inputs.size(), nullptr);
+  for (size_t i = 0; i < inputs.size(); i++) {
+    spectra[i].channel = inputs[i].metadata.channel;
+    const size_t length = SegmentLength(inputs[i].metadata.sample_count);
+    if (length == 0 || inputs[i].samples == nullptr) {
+      spdlog::warn("Record of CH{} too short for spectrum analysis",
+                   inputs[i].metadata.channel);
+      continue;
+    }
+    tables[i] = &PrepareWindow(length);
+  }
+
+  std::vector<std::future<void>> tasks;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    if (tables[i] == nullptr) {
+      continue;
+    }
+    tasks.push_back(std::async(std::launch::async, [&, i]() {
+      AnalyzeChannel(inputs[i], *tables[i], this->workspaces[i], spectra[i]);
+    }));
+  }
+  for (auto &task : tasks) {
+    task.get();
+  }
+  return spectra;
+}
+/*
+ * PUBLIC METHODS END
+ */
+
+/*
+ *   PRIVATE METHODS BEGIN
+ */
+size_t SpectrumAnalyzer::SegmentLength(size_t record_length) const {
+  size_t length = record_length;
+  if (this->settings.segment_length > 0) {
+    length = std::min(length, this->settings.segment_length);
+  }
+  length &= ~size_t(1); // FFT of real data needs even length
+  return length < MIN_SEGMENT_LENGTH ? 0 : length;
+}
+
+const SpectrumAnalyzer::WindowTable &
+SpectrumAnalyzer::PrepareWindow(size_t length) {
+  auto found = this->windows.find(length);
+  if (found != this->windows.end()) {
+    return found->second;
+  }
+
+  // periodic windows, cosine sum coefficients
+  std::vector<double> terms;
+  switch (this->settings.window) {
+  case WindowType::Blackman:
+    terms = {0.42, 0.5, 0.08};
+    break;
+  case WindowType::FlatTop:
+    terms = {0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368};
+    break;
+  case WindowType::Hann:
+  default:
+    terms = {0.5, 0.5};
+    break;
+  }
+
+  WindowTable &table = this->windows[length];
+  table.coefficients.resize(length);
+  double sum = 0.0;
+  double sum_squares = 0.0;
+  for (size_t n = 0; n < length; n++) {
+    double value = 0.0;
+    double sign = 1.0;
+    for (size_t term = 0; term < terms.size(); term++) {
+      value += sign * terms[term] * std::cos(TWO_PI * term * n / length);
+      sign = -sign;
+    }
+    table.coefficients[n] = value;
+    sum += value;
+    sum_squares += value * value;
+  }
+  table.coherent_gain = sum;
+  table.noise_bins = length * sum_squares / (sum * sum);
+  return table;
+}
+
+void SpectrumAnalyzer::AnalyzeChannel(const SpectrumInput &input,
+                                      const WindowTable &window,
+                                      ChannelWorkspace &workspace,
+                                      Spectrum &spectrum) const {
+  decodeVolts(input.samples, input.metadata, workspace.volts);
+
+  const size_t length = window.coefficients.size();
+  const size_t step = std::max<size_t>(
+      1, (size_t)std::lround(length * (1.0 - this->settings.overlap)));
+  auto plan = FftPlan::Get(length);
+  const size_t bins = plan->BinCount();
+  spectrum.power.assign(bins, 0.0f);
+  workspace.segment.resize(length);
+
+  const float *coefficients = window.coefficients.data();
+  for (size_t start = 0; start + length <= workspace.volts.size();
+       start += step) {
+    const float *volts = workspace.volts.data() + start;
+    float *segment = workspace.segment.data();
+    for (size_t n = 0; n < length; n++) {
+      segment[n] = volts[n] * coefficients[n];
+    }
+    plan->Transform(segment, workspace.fft);
+
+    const float *bin_re = workspace.fft.bin_re.data();
+    const float *bin_im = workspace.fft.bin_im.data();
+    float *power = spectrum.power.data();
+    for (size_t k = 0; k < bins; k++) {
+      power[k] += bin_re[k] * bin_re[k] + bin_im[k] * bin_im[k];
+    }
+    spectrum.averages++;
+  }
+
+  // one-sided spectrum: bins other than DC and Nyquist hold both halves
+  const double scale =
+      2.0 / (window.coherent_gain * window.coherent_gain * spectrum.averages);
+  for (float &value : spectrum.power) {
+    value *= scale;
+  }
+  spectrum.power.front() *= 0.5f;
+  spectrum.power.back() *= 0.5f;
+
+  spectrum.bin_width = 1.0 / (length * input.metadata.scaling.x_increment);
+  MeasureTones(spectrum, window);
+}
+
+/**
+ * Dominant tone is the highest peak outside DC, its frequency is the
+ * power-weighted centre of its main lobe. THD sums main lobes of harmonics
+ * of that frequency, noise is what remains outside DC, fundamental and
+ * harmonic lobes, extrapolated over the whole band. Sidelobes of strong
+ * tones fall below the noise floor only far from the main lobe, so bins
+ * around each lobe are left out of noise while they stay above the floor.
+ */
+void SpectrumAnalyzer::MeasureTones(Spectrum &spectrum,
+                                    const WindowTable &window) const {
+  const std::vector<float> &power = spectrum.power;
+  const size_t lobe = lobeHalfWidth(this->settings.window);
+  const size_t last = power.size() - 1;
+  if (last <= 2 * lobe) {
+    return;
+  }
+
+  std::vector<bool> excluded(power.size(), false);
+  std::vector<std::pair<size_t, size_t>> lobes; // first and last bin
+  // sums lobe bins not yet assigned to another tone, in V^2
+  auto lobePower = [&](size_t center, double *weighted_bin) {
+    double sum = 0.0;
+    double moment = 0.0;
+    const size_t begin = center > lobe ? center - lobe : 0;
+    const size_t end = std::min(center + lobe, last);
+    for (size_t k = begin; k <= end; k++) {
+      if (!excluded[k]) {
+        sum += power[k];
+        moment += power[k] * k;
+        excluded[k] = true;
+      }
+    }
+    lobes.emplace_back(begin, end);
+    if (weighted_bin != nullptr) {
+      *weighted_bin = sum > 0.0 ? moment / sum : center;
+    }
+    return sum / window.noise_bins;
+  };
+  auto peakBin = [&](size_t begin, size_t end) {
+    return std::max_element(power.begin() + begin, power.begin() + end + 1) -
+           power.begin();
+  };
+
+  lobePower(0, nullptr); // DC
+  const size_t peak = peakBin(lobe + 1, last);
+  double fundamental_bin = peak;
+  const double fundamental = lobePower(peak, &fundamental_bin);
+  if (fundamental <= 0.0) {
+    return;
+  }
+  spectrum.dominant_frequency = fundamental_bin * spectrum.bin_width;
+  spectrum.dominant_rms = std::sqrt(fundamental);
+
+  double harmonics = 0.0;
+  for (int order = 2; order <= this->settings.harmonics; order++) {
+    const size_t expected = (size_t)std::lround(order * fundamental_bin);
+    if (expected + lobe > last) {
+      break;
+    }
+    // harmonic may be off its nominal bin due to frequency estimate error
+    harmonics += lobePower(peakBin(expected - lobe, expected + lobe), nullptr);
+  }
+  spectrum.thd = std::sqrt(harmonics / fundamental);
+
+  // median is not moved by the few bins holding tones
+  std::vector<float> sorted(power.begin() + 1, power.end());
+  std::nth_element(
+      sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+  const double leakage_level = LEAKAGE_THRESHOLD * sorted[sorted.size() / 2];
+  for (const auto &[begin, end] : lobes) {
+    for (size_t k = end + 1; k <= last && power[k] > leakage_level; k++) {
+      excluded[k] = true;
+    }
+    for (size_t k = begin; k-- > 0 && power[k] > leakage_level;) {
+      excluded[k] = true;
+    }
+  }
+
+  double noise = 0.0;
+  size_t noise_bins = 0;
+  for (size_t k = 0; k <= last; k++) {
+    if (!excluded[k]) {
+      noise += power[k];
+      noise_bins++;
+    }
+  }
+  if (noise_bins > 0 && noise > 0.0) {
+    noise = noise / window.noise_bins * power.size() / noise_bins;
+    spectrum.snr_db = 10.0 * std::log10(fundamental / noise);
+  }
+}
+/*
+ *   PRIVATE METHODS END
+ */
+} // namespace WaveformProcessing
@@ -0,0 +1,114 @@
+/*********************************************************************
+ * \file   WaveformRecord.cpp
+ * \brief  Sample decoding and summary statistics of waveform records
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "WaveformRecord.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace WaveformProcessing {
+// fraction of Vpp a signal has to pass mid level by to count as crossing
+constexpr double CROSSING_HYSTERESIS = 0.1;
+
+int32_t sampleCode(const uint8_t *samples,
+                   size_t index,
+                   const RecordMetadata &metadata) {
+  if (metadata.sample_width == 2) {
+    uint16_t code =
+        (uint16_t)(samples[2 * index] << 8 | samples[2 * index + 1]);
+    return metadata.signed_samples ? (int16_t)code : code;
+  }
+  return metadata.signed_samples ? (int8_t)samples[index] : samples[index];
+}
+
+void decodeVolts(const uint8_t *samples,
+                 const RecordMetadata &metadata,
+                 std::vector<float> &volts) {
+  const WaveformScaling &scaling = metadata.scaling;
+  volts.resize(metadata.sample_count);
+  for (size_t i = 0; i < metadata.sample_count; i++) {
+    volts[i] = (sampleCode(samples, i, metadata) - scaling.y_reference) *
+                   scaling.y_increment +
+               scaling.y_origin;
+  }
+}
+
+RecordStats computeStats(const uint8_t *samples,
+                         const RecordMetadata &metadata) {
+  RecordStats stats;
+  const size_t count = metadata.sample_count;
+  if (count == 0) {
+    return stats;
+  }
+
+  // statistics are gathered on integer codes and converted once
+  int32_t min_code = std::numeric_limits<int32_t>::max();
+  int32_t max_code = std::numeric_limits<int32_t>::min();
+  double sum = 0.0;
+  double sum_squares = 0.0;
+  for (size_t i = 0; i < count; i++) {
+    int32_t code = sampleCode(samples, i, metadata);
+    min_code = std::min(min_code, code);
+    max_code = std::max(max_code, code);
+    sum += code;
+    sum_squares += (double)code * code;
+  }
+
+  const WaveformScaling &scaling = metadata.scaling;
+  auto toVolts = [&](double code) {
+    return (code - scaling.y_reference) * scaling.y_increment +
+           scaling.y_origin;
+  };
+  // E[(c - a)^2] with a being the code of 0 V
+  const double mean_code = sum / count;
+  const double zero_code =
+      scaling.y_increment != 0.0
+          ? scaling.y_reference - scaling.y_origin / scaling.y_increment
+          : 0.0;
+  const double mean_square_codes = sum_squares / count -
+                                   2.0 * zero_code * mean_code +
+                                   zero_code * zero_code;
+
+  stats[Stat::Min] = toVolts(scaling.y_increment >= 0 ? min_code : max_code);
+  stats[Stat::Max] = toVolts(scaling.y_increment >= 0 ? max_code : min_code);
+  stats[Stat::Vpp] = stats[Stat::Max] - stats[Stat::Min];
+  stats[Stat::Mean] = toVolts(mean_code);
+  stats[Stat::Rms] = std::fabs(scaling.y_increment) *
+                     std::sqrt(std::max(0.0, mean_square_codes));
+
+  // rising mid level crossings with hysteresis
+  const double mid_code = (min_code + max_code) / 2.0;
+  const double hysteresis = CROSSING_HYSTERESIS * (max_code - min_code) / 2.0;
+  if (hysteresis <= 0.0) {
+    return stats;
+  }
+  bool armed = false;
+  size_t first_crossing = 0;
+  size_t last_crossing = 0;
+  size_t crossings = 0;
+  for (size_t i = 0; i < count; i++) {
+    int32_t code = sampleCode(samples, i, metadata);
+    if (code < mid_code - hysteresis) {
+      armed = true;
+    } else if (armed && code > mid_code + hysteresis) {
+      armed = false;
+      if (crossings == 0) {
+        first_crossing = i;
+      }
+      last_crossing = i;
+      crossings++;
+    }
+  }
+  if (crossings >= 2 && scaling.x_increment > 0.0) {
+    stats[Stat::Frequency] =
+        (crossings - 1) /
+        ((last_crossing - first_crossing) * scaling.x_increment);
+  }
+
+  return stats;
+}
+} // namespace WaveformProcessing
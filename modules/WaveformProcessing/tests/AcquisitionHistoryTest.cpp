@@ -0,0 +1,74 @@
+/*********************************************************************
+ * \file   AcquisitionHistoryTest.cpp
+ * \brief  Unit tests of AcquisitionHistory
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "AcquisitionHistory.hpp"
+#include "TestSupport.hpp"
+
+using namespace WaveformProcessing;
+
+// two periods of a square wave, frequency set with sample interval
+static uint64_t appendSquareWave(AcquisitionHistory &history,
+                                 double frequency) {
+  static const uint8_t samples[] = {0, 100, 0, 100};
+  RecordMetadata metadata;
+  metadata.sample_count = sizeof(samples);
+  metadata.scaling.x_increment = 0.5 / frequency;
+  return history.Append(metadata, samples, sizeof(samples));
+}
+
+static void testFindInRange() {
+  AcquisitionHistory history(1024, 16);
+  for (int i = 0; i < 10; i++) {
+    appendSquareWave(history, 1000.0 * (i + 1));
+  }
+  auto ids = history.FindInRange(Stat::Frequency, 2500.0f, 5500.0f);
+  CHECK(ids.size() == 3);
+  CHECK(ids.size() == 3 && ids[0] == 3 && ids[2] == 5);
+}
+
+static void testEviction() {
+  // 4 B records, 8 fit in the arena
+  AcquisitionHistory history(32, 100);
+  for (int i = 0; i < 20; i++) {
+    appendSquareWave(history, 1000.0);
+  }
+  CHECK(history.Size() == 8);
+  CHECK(history.FirstId() == 13);
+  CHECK(history.LastId() == 20);
+  HistoryRecord record;
+  CHECK(!history.Get(12, record));
+  CHECK(history.Get(13, record) && record.bytes == 4);
+}
+
+// large mean and small spread, sums of squares in float found nothing
+static void testOutliersOfLargeMean() {
+  const size_t count = 33000;
+  const size_t planted = 20000;
+  AcquisitionHistory history(4 * count, count);
+  uint64_t planted_id = 0;
+  for (size_t i = 0; i < count; i++) {
+    const double frequency = 1e6 + (double)(i % 3) - 1.0;
+    if (i == planted) {
+      planted_id = appendSquareWave(history, frequency + 50.0);
+    } else {
+      appendSquareWave(history, frequency);
+    }
+  }
+  CHECK(history.Size() == count);
+
+  auto ids = history.FindOutliers(Stat::Frequency, 3.0f);
+  CHECK(ids.size() == 1);
+  CHECK(!ids.empty() && ids[0] == planted_id);
+  CHECK(history.FindOutliers(Stat::Frequency, 100.0f).empty());
+}
+
+int main() {
+  testFindInRange();
+  testEviction();
+  testOutliersOfLargeMean();
+  return TestSupport::Result();
+}
@@ -0,0 +1,115 @@
+/*********************************************************************
+ * \file   AsciiCurveParserTest.cpp
+ * \brief  Unit tests of AsciiCurveParser reply formats and threaded parse
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "AsciiCurveParser.hpp"
+#include "TestSupport.hpp"
+#include <random>
+#include <string>
+
+using namespace WaveformProcessing;
+
+static std::vector<int16_t> parseCodes(const AsciiCurveParser &parser,
+                                       std::string_view reply,
+                                       bool &success) {
+  std::vector<int16_t> codes(parser.CountValues(reply));
+  size_t count = 0;
+  success = parser.Parse(reply, codes.data(), codes.size(), count);
+  codes.resize(count);
+  return codes;
+}
+
+static void testReplyFormats() {
+  AsciiCurveParser parser(1);
+  bool success = false;
+
+  auto codes = parseCodes(parser, ":CURVE 12,-3,45\n", success);
+  CHECK(success);
+  CHECK((codes == std::vector<int16_t>{12, -3, 45}));
+
+  codes = parseCodes(parser, "CURV 7, +8 ,-32768,32767\r\n", success);
+  CHECK(success);
+  CHECK((codes == std::vector<int16_t>{7, 8, -32768, 32767}));
+
+  // IEEE 488.2 block header, one digit of length then 5 bytes
+  codes = parseCodes(parser, "#151,2,3\n", success);
+  CHECK(success);
+  CHECK((codes == std::vector<int16_t>{1, 2, 3}));
+
+  // command header followed by block header
+  codes = parseCodes(parser, ":CURVE #191,-2,3,40\n", success);
+  CHECK(success);
+  CHECK((codes == std::vector<int16_t>{1, -2, 3, 40}));
+
+  codes = parseCodes(parser, " \n", success);
+  CHECK(success && codes.empty());
+
+  const std::string_view volts = "-1.2e-3,4.5e-3,+0.25,1E2\n";
+  std::vector<float> values(parser.CountValues(volts));
+  size_t count = 0;
+  CHECK(values.size() == 4);
+  CHECK(parser.Parse(volts, values.data(), values.size(), count));
+  CHECK(count == 4);
+  CHECK_NEAR(values[0], -1.2e-3, 1e-9);
+  CHECK_NEAR(values[1], 4.5e-3, 1e-9);
+  CHECK_NEAR(values[2], 0.25, 1e-9);
+  CHECK_NEAR(values[3], 100.0, 1e-9);
+}
+
+static void testRejectsMalformed() {
+  AsciiCurveParser parser(1);
+  bool success = true;
+  parseCodes(parser, "1,x,3\n", success);
+  CHECK(!success);
+  parseCodes(parser, "1,,3\n", success);
+  CHECK(!success);
+  parseCodes(parser, "1,40000\n", success); // out of int16 range
+  CHECK(!success);
+
+  int16_t codes[2];
+  size_t count = 0;
+  CHECK(!parser.Parse("1,2,3", codes, 2, count));
+  CHECK(count == 0);
+}
+
+/**
+ * Reply large enough to be split into ranges parsed by several threads
+ * gives the same values in the same order as one thread.
+ */
+static void testThreadedParse() {
+  std::mt19937 generator(32);
+  std::uniform_int_distribution<int> value(-32768, 32767);
+  std::vector<int16_t> expected(400000);
+  std::string reply = ":CURVE ";
+  for (size_t i = 0; i < expected.size(); i++) {
+    expected[i] = (int16_t)value(generator);
+    reply += std::to_string(expected[i]);
+    reply += i + 1 < expected.size() ? "," : "\n";
+  }
+
+  for (unsigned threads : {1u, 3u, 8u}) {
+    AsciiCurveParser parser(threads);
+    bool success = false;
+    CHECK(parser.CountValues(reply) == expected.size());
+    auto codes = parseCodes(parser, reply, success);
+    CHECK(success);
+    CHECK(codes == expected);
+  }
+
+  // malformed field in a range parsed by another thread
+  reply[reply.size() * 3 / 4] = 'x';
+  AsciiCurveParser parser(4);
+  bool success = true;
+  parseCodes(parser, reply, success);
+  CHECK(!success);
+}
+
+int main() {
+  testReplyFormats();
+  testRejectsMalformed();
+  testThreadedParse();
+  return TestSupport::Result();
+}
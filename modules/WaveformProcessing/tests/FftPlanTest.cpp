@@ -0,0 +1,128 @@
+/*********************************************************************
+ * \file   FftPlanTest.cpp
+ * \brief  Unit tests of FftPlan against a direct DFT
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "FftPlan.hpp"
+#include "TestSupport.hpp"
+#include <random>
+
+using namespace WaveformProcessing;
+
+// bins of real input computed in double precision, O(N^2)
+static void naiveDft(const std::vector<float> &input,
+                     std::vector<double> &re,
+                     std::vector<double> &im) {
+  const size_t length = input.size();
+  std::vector<double> cosine(length), sine(length);
+  for (size_t n = 0; n < length; n++) {
+    cosine[n] = std::cos(-2.0 * M_PI * n / length);
+    sine[n] = std::sin(-2.0 * M_PI * n / length);
+  }
+  re.assign(length / 2 + 1, 0.0);
+  im.assign(length / 2 + 1, 0.0);
+  for (size_t k = 0; k <= length / 2; k++) {
+    size_t index = 0; // k * n modulo length
+    for (size_t n = 0; n < length; n++) {
+      re[k] += input[n] * cosine[index];
+      im[k] += input[n] * sine[index];
+      index += k;
+      index -= index >= length ? length : 0;
+    }
+  }
+}
+
+/**
+ * Lengths cover every stage radix (4, 2, 3, 5), direct DFT stages of other
+ * small prime factors, their mixes and Bluestein transforms of lengths
+ * with a large prime factor.
+ */
+static void testMatchesDft() {
+  const size_t lengths[] = {2,  4,  8,   16,  64,  4096, 6,  12,   18,
+                            96, 10, 50,  160, 1000, 14,  22, 154,  62,
+                            74, 94, 206, 6002, 20014};
+  std::mt19937 generator(31);
+  std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+  FftWorkspace workspace;
+
+  for (size_t length : lengths) {
+    std::vector<float> input(length);
+    for (float &sample : input) {
+      sample = value(generator);
+    }
+    std::vector<double> re, im;
+    naiveDft(input, re, im);
+
+    auto plan = FftPlan::Get(length);
+    CHECK(plan->Length() == length);
+    CHECK(plan->BinCount() == length / 2 + 1);
+    plan->Transform(input.data(), workspace);
+
+    // float rounding grows with log N, bins are up to N / 2 in size
+    const double tolerance = 1e-5 * length;
+    double error = 0.0;
+    for (size_t k = 0; k < plan->BinCount(); k++) {
+      error = std::max(error, std::abs(workspace.bin_re[k] - re[k]));
+      error = std::max(error, std::abs(workspace.bin_im[k] - im[k]));
+    }
+    if (error > tolerance) {
+      std::fprintf(stderr, "length %zu\n", length);
+    }
+    CHECK_NEAR(error, 0.0, tolerance);
+  }
+}
+
+// workspace reused for another length must not keep stale bins
+static void testWorkspaceReuse() {
+  FftWorkspace workspace;
+  std::vector<float> ones(48, 1.0f);
+  FftPlan::Get(48)->Transform(ones.data(), workspace);
+  CHECK_NEAR(workspace.bin_re[0], 48.0, 1e-4);
+
+  std::vector<float> tone(20);
+  for (size_t n = 0; n < tone.size(); n++) {
+    tone[n] = std::cos(2.0 * M_PI * 3 * n / tone.size());
+  }
+  FftPlan::Get(20)->Transform(tone.data(), workspace);
+  CHECK_NEAR(workspace.bin_re[0], 0.0, 1e-4);
+  CHECK_NEAR(workspace.bin_re[3], 10.0, 1e-4);
+  CHECK_NEAR(workspace.bin_im[3], 0.0, 1e-4);
+  CHECK(FftPlan::Get(20) == FftPlan::Get(20));
+}
+
+/**
+ * Whole record decimated by 3 from 1 Mpt has half length 166667, a prime.
+ * Direct DFT stage of that radix would need a 166667^2 root table.
+ */
+static void testLargePrimeLength() {
+  const size_t length = 333334;
+  const size_t tone_bin = 12345;
+  std::vector<float> tone(length);
+  for (size_t n = 0; n < length; n++) {
+    tone[n] = std::cos(2.0 * M_PI * ((tone_bin * n) % length) / length);
+  }
+  FftWorkspace workspace;
+  auto plan = FftPlan::Get(length);
+  CHECK(plan->BinCount() == length / 2 + 1);
+  plan->Transform(tone.data(), workspace);
+
+  CHECK_NEAR(workspace.bin_re[tone_bin], length / 2.0, 1e-3 * length);
+  double leakage = 0.0;
+  for (size_t k = 0; k < plan->BinCount(); k++) {
+    if (k != tone_bin) {
+      leakage = std::max(leakage,
+                         (double)std::hypot(workspace.bin_re[k],
+                                            workspace.bin_im[k]));
+    }
+  }
+  CHECK_NEAR(leakage, 0.0, 1e-4 * length);
+}
+
+int main() {
+  testMatchesDft();
+  testLargePrimeLength();
+  testWorkspaceReuse();
+  return TestSupport::Result();
+}
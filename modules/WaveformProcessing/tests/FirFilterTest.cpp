@@ -0,0 +1,181 @@
+/*********************************************************************
+ * \file   FirFilterTest.cpp
+ * \brief  Unit tests of FirFilter streaming, response and record scaling
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "FirFilter.hpp"
+#include "TestSupport.hpp"
+#include <random>
+
+using namespace WaveformProcessing;
+
+constexpr double SAMPLE_RATE = 1e6;
+
+static std::vector<float> noise(size_t count) {
+  std::mt19937 generator(37);
+  std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+  std::vector<float> samples(count);
+  for (float &sample : samples) {
+    sample = value(generator);
+  }
+  return samples;
+}
+
+// peak of the output after the filter settled on a sine input
+static double toneGain(FirFilter &filter, double frequency) {
+  const size_t count = 20000;
+  std::vector<float> input(count);
+  for (size_t n = 0; n < count; n++) {
+    input[n] = std::sin(2.0 * M_PI * frequency * n / SAMPLE_RATE);
+  }
+  filter.Reset();
+  std::vector<float> output(filter.OutputCount(count));
+  output.resize(filter.Process(input.data(), count, output.data()));
+  double peak = 0.0;
+  for (size_t i = output.size() / 2; i < output.size(); i++) {
+    peak = std::max(peak, (double)std::abs(output[i]));
+  }
+  return peak;
+}
+
+/**
+ * Input split into blocks of any size gives the same output as one block,
+ * including the decimation phase carried over block boundaries.
+ */
+static void testSplitMatchesWhole() {
+  FilterSettings settings;
+  settings.taps = 63;
+  settings.decimation = 3;
+  settings.high_cutoff = 50e3;
+  FirFilter filter(settings);
+  CHECK(filter.Design(SAMPLE_RATE));
+
+  const std::vector<float> input = noise(10000);
+  std::vector<float> whole(filter.OutputCount(input.size()));
+  whole.resize(filter.Process(input.data(), input.size(), whole.data()));
+  CHECK(whole.size() == (input.size() + 2) / 3);
+
+  filter.Reset();
+  std::vector<float> split;
+  const size_t blocks[] = {1, 2, 7, 62, 63, 64, 100, 1, 5000};
+  size_t offset = 0;
+  for (size_t i = 0; offset < input.size(); i++) {
+    const size_t count =
+        i < std::size(blocks) ? blocks[i] : input.size() - offset;
+    std::vector<float> output(filter.OutputCount(count));
+    output.resize(filter.Process(input.data() + offset, count, output.data()));
+    split.insert(split.end(), output.begin(), output.end());
+    offset += count;
+  }
+
+  CHECK(split.size() == whole.size());
+  double error = 0.0;
+  for (size_t i = 0; i < std::min(split.size(), whole.size()); i++) {
+    error = std::max(error, (double)std::abs(split[i] - whole[i]));
+  }
+  CHECK_NEAR(error, 0.0, 1e-6);
+}
+
+static void testLowPassResponse() {
+  FilterSettings settings;
+  settings.taps = 255;
+  settings.high_cutoff = 20e3;
+  FirFilter filter(settings);
+  CHECK(filter.Design(SAMPLE_RATE));
+  CHECK(filter.GetCoefficients().size() == 255);
+
+  CHECK_NEAR(toneGain(filter, 2e3), 1.0, 1e-3);
+  CHECK(toneGain(filter, 100e3) < 1e-3);
+
+  // constant input passes with unity gain, stream starts without a step
+  std::vector<float> ones(500, 1.0f), output(500);
+  filter.Reset();
+  filter.Process(ones.data(), ones.size(), output.data());
+  CHECK_NEAR(output.front(), 1.0, 1e-5);
+  CHECK_NEAR(output.back(), 1.0, 1e-5);
+}
+
+static void testBandPassResponse() {
+  FilterSettings settings;
+  settings.type = FilterType::BandPass;
+  settings.taps = 511;
+  settings.low_cutoff = 40e3;
+  settings.high_cutoff = 60e3;
+  FirFilter filter(settings);
+  CHECK(filter.Design(SAMPLE_RATE));
+  CHECK_NEAR(toneGain(filter, 50e3), 1.0, 1e-2);
+  CHECK(toneGain(filter, 5e3) < 1e-3);
+  CHECK(toneGain(filter, 200e3) < 1e-3);
+
+  settings.low_cutoff = 70e3; // above high cutoff
+  filter.SetSettings(settings);
+  CHECK(!filter.Design(SAMPLE_RATE));
+  settings.type = FilterType::LowPass;
+  settings.high_cutoff = 600e3; // above Nyquist
+  filter.SetSettings(settings);
+  CHECK(!filter.Design(SAMPLE_RATE));
+}
+
+/**
+ * Filtered record decodes to the same volts as constant input and two
+ * records continue one stream like a single longer record.
+ */
+static void testRecordStream() {
+  RecordMetadata metadata;
+  metadata.sample_width = 1;
+  metadata.signed_samples = false;
+  metadata.scaling.x_increment = 1.0 / SAMPLE_RATE;
+  metadata.scaling.y_increment = 0.01;
+  metadata.scaling.y_origin = -0.5;
+  metadata.scaling.y_reference = 100;
+  metadata.sample_count = 4000;
+  std::vector<uint8_t> samples(metadata.sample_count);
+  for (size_t n = 0; n < samples.size(); n++) {
+    samples[n] = 128 + std::lround(
+                           100 * std::sin(2.0 * M_PI * 1e3 * n / SAMPLE_RATE));
+  }
+
+  FilterSettings settings;
+  settings.taps = 31;
+  settings.decimation = 4;
+  FirFilter whole_filter(settings);
+  RecordMetadata whole_metadata;
+  std::vector<uint8_t> whole;
+  CHECK(whole_filter.ProcessRecord(
+      samples.data(), metadata, whole_metadata, whole));
+  CHECK(whole_metadata.sample_count == 1000);
+  CHECK(whole_metadata.sample_width == 2 && whole_metadata.signed_samples);
+  CHECK_NEAR(whole_metadata.scaling.x_increment, 4.0 / SAMPLE_RATE, 1e-15);
+
+  // 1 kHz passes, filtered volts follow the input volts
+  std::vector<float> input_volts, filtered_volts;
+  decodeVolts(samples.data(), metadata, input_volts);
+  decodeVolts(whole.data(), whole_metadata, filtered_volts);
+  const size_t delay = 15; // (taps - 1) / 2 inputs
+  for (size_t i = 10; i < filtered_volts.size(); i += 97) {
+    CHECK_NEAR(filtered_volts[i], input_volts[4 * i - delay], 0.02);
+  }
+
+  FirFilter split_filter(settings);
+  RecordMetadata part = metadata;
+  part.sample_count = 1500; // not a multiple of decimation
+  RecordMetadata first_metadata, second_metadata;
+  std::vector<uint8_t> first, second;
+  CHECK(split_filter.ProcessRecord(
+      samples.data(), part, first_metadata, first));
+  part.sample_count = metadata.sample_count - 1500;
+  CHECK(split_filter.ProcessRecord(
+      samples.data() + 1500, part, second_metadata, second));
+  first.insert(first.end(), second.begin(), second.end());
+  CHECK(first == whole);
+}
+
+int main() {
+  testSplitMatchesWhole();
+  testLowPassResponse();
+  testBandPassResponse();
+  testRecordStream();
+  return TestSupport::Result();
+}
@@ -0,0 +1,88 @@
+/*********************************************************************
+ * \file   SpectrumAnalyzerTest.cpp
+ * \brief  Unit tests of SpectrumAnalyzer tone, THD and SNR measurement
+ *
+ * \date   October 2026
+ *********************************************************************/
+
+#include "SpectrumAnalyzer.hpp"
+#include "TestSupport.hpp"
+#include <random>
+
+using namespace WaveformProcessing;
+
+constexpr double SAMPLE_RATE = 100e3;
+constexpr double TONE_FREQUENCY = 1234.5678; // between bins
+constexpr double VOLTS_PER_CODE = 1.0 / 30000;
+
+/**
+ * Signed 16 bit record of a 1 V amplitude tone with harmonic and white
+ * noise of given levels relative to the tone power.
+ */
+static void makeRecord(double snr_db,
+                       double harmonic_db,
+                       SpectrumInput &input,
+                       std::vector<uint8_t> &samples) {
+  const size_t count = 65536;
+  const double noise_rms = std::sqrt(0.5 / std::pow(10.0, snr_db / 10.0));
+  const double harmonic = std::pow(10.0, harmonic_db / 20.0);
+  std::mt19937 generator(1234);
+  std::normal_distribution<double> noise(0.0, noise_rms);
+
+  samples.resize(2 * count);
+  for (size_t i = 0; i < count; i++) {
+    const double phase = 2.0 * M_PI * TONE_FREQUENCY * i / SAMPLE_RATE;
+    const double volts = std::sin(phase) + harmonic * std::sin(2.0 * phase) +
+                         noise(generator);
+    const int16_t code = (int16_t)std::lround(volts / VOLTS_PER_CODE);
+    samples[2 * i] = (uint8_t)((uint16_t)code >> 8);
+    samples[2 * i + 1] = (uint8_t)code;
+  }
+  input.metadata.sample_width = 2;
+  input.metadata.signed_samples = true;
+  input.metadata.sample_count = count;
+  input.metadata.scaling.x_increment = 1.0 / SAMPLE_RATE;
+  input.metadata.scaling.y_increment = VOLTS_PER_CODE;
+  input.samples = samples.data();
+}
+
+static Spectrum analyze(WindowType window, const SpectrumInput &input) {
+  SpectrumSettings settings;
+  settings.window = window;
+  settings.segment_length = 4096;
+  SpectrumAnalyzer analyzer(settings);
+  auto spectra = analyzer.Analyze({input});
+  CHECK(spectra.size() == 1);
+  return spectra.empty() ? Spectrum() : spectra[0];
+}
+
+// main lobe leakage must not be counted as noise with any window
+static void testKnownSnr() {
+  SpectrumInput input;
+  std::vector<uint8_t> samples;
+  makeRecord(57.0, -300.0, input, samples);
+
+  for (WindowType window :
+       {WindowType::Hann, WindowType::Blackman, WindowType::FlatTop}) {
+    const Spectrum spectrum = analyze(window, input);
+    CHECK_NEAR(spectrum.snr_db, 57.0, 0.5);
+    CHECK_NEAR(spectrum.dominant_frequency, TONE_FREQUENCY, 0.2);
+    CHECK_NEAR(spectrum.dominant_rms, std::sqrt(0.5), 0.01);
+  }
+}
+
+static void testHarmonicDistortion() {
+  SpectrumInput input;
+  std::vector<uint8_t> samples;
+  makeRecord(80.0, -40.0, input, samples);
+
+  const Spectrum spectrum = analyze(WindowType::Hann, input);
+  CHECK_NEAR(spectrum.thd, 0.01, 0.0005);
+  CHECK(spectrum.averages == 31);
+}
+
+int main() {
+  testKnownSnr();
+  testHarmonicDistortion();
+  return TestSupport::Result();
+}